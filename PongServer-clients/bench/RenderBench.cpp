@@ -0,0 +1,213 @@
+// Headless render benchmark.
+// Draws the game with SDL's software renderer into an in-memory surface, so render cost can be
+// measured on machines without a GPU or display. The real assets are loaded, MyGame is fed
+// synthetic GAME_DATA snapshots, and every frame goes through update(), tick(), buildFrame()
+// (which calls updateGUI()) and drawFrame(), optionally with thousands of extra sprites.
+//
+// Usage: RenderBench [--frames 1000] [--sprites 0] [--assets DIR] [--calls 1000]
+
+#include "MyGame.h"
+#include "Timing.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Samples: timings of one stage, one sample per frame or call (ms)
+struct Samples {
+    std::vector<double> values;
+
+    void add(double ms) { values.push_back(ms); }
+
+    double mean() const {
+        double sum = 0;
+        for (double v : values) {
+            sum += v;
+        }
+        return values.empty() ? 0 : sum / values.size();
+    }
+
+    double percentile(double p) const {
+        if (values.empty()) {
+            return 0;
+        }
+        std::vector<double> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[(size_t)((sorted.size() - 1) * p)];
+    }
+};
+
+static void report(const char* name, const Samples& samples) {
+    std::cout << "  " << name << ": mean " << samples.mean() * 1000 << " us, p50 " << samples.percentile(0.5) * 1000
+              << " us, p99 " << samples.percentile(0.99) * 1000 << " us" << std::endl;
+}
+
+// A server snapshot for frame n: the ball bounces around the court and both paddles follow it
+static std::vector<std::string> syntheticSnapshot(int n) {
+    const int period = 240;
+    int phase = n % (2 * period);
+    float ballX = 200.0f + 380.0f * (phase < period ? phase : 2 * period - phase) / period;
+    int vphase = (n * 3) % (2 * period);
+    float ballY = 20.0f + 540.0f * (vphase < period ? vphase : 2 * period - vphase) / period;
+    float paddleY = std::min(540.0f, std::max(0.0f, ballY - 30));
+
+    return {
+        std::to_string(paddleY), std::to_string(paddleY), std::to_string(ballX), std::to_string(ballY),
+        "200", "580", "1", std::to_string(n / 600), std::to_string(n / 900), std::to_string(n),
+        "300", "300", std::to_string(n), std::to_string(n * 1000.0 / 60), "8"
+    };
+}
+
+int main(int argc, char** argv) {
+    int frames = 1000;
+    int extraSprites = 0;
+    int calls = 1000;
+    std::string assets;  // Empty: found the same way the client finds them
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--sprites") == 0 && i + 1 < argc) {
+            extraSprites = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--calls") == 0 && i + 1 < argc) {
+            calls = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--assets") == 0 && i + 1 < argc) {
+            assets = argv[++i];
+        }
+    }
+
+    // No display or sound card is needed
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    if (SDL_Init(0) == -1) {
+        std::cerr << "SDL_Init: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 800, 600, 32, SDL_PIXELFORMAT_RGBA8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        std::cerr << "Failed to create the software renderer: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    MyGame* game = new MyGame();
+    game->assetRoot = assets;
+    game->latencyLogIntervalMs = 0;
+    double loadStart = nowMs();
+    game->loadTextures(renderer);
+    double loadMs = nowMs() - loadStart;
+
+    Sprite ballSprite = game->getSprite("ball");
+    if (!ballSprite.isValid()) {
+        std::cerr << "Assets not found (use --assets DIR)" << std::endl;
+        return 1;
+    }
+
+    // Frames: the whole pipeline, as the client runs it
+    Samples frameTimes, updateTimes, tickTimes, buildTimes, drawTimes;
+    std::vector<std::string> discarded;
+    int drawCalls = 0;
+    Uint32 seed = 12345;
+    std::vector<SDL_Rect> extras(extraSprites);
+    for (SDL_Rect& rect : extras) {
+        seed = seed * 1664525 + 1013904223;
+        rect = { (int)(seed % 780), (int)((seed >> 10) % 580), 20, 20 };
+    }
+
+    for (int n = 0; n < frames; n++) {
+        std::vector<std::string> args = syntheticSnapshot(n);
+        game->on_receive("GAME_DATA", args);
+
+        double start = nowMs();
+        game->update();
+        double updated = nowMs();
+        game->tick();
+        game->takeMessages(discarded);  // No network thread here to send them
+        double ticked = nowMs();
+
+        FramePacket packet;
+        game->buildFrame(packet, 0.5f);
+        for (SDL_Rect& rect : extras) {
+            rect.x = (rect.x + 3) % 780;  // Keep them moving so nothing can be cached
+            packet.addSprite(ballSprite, rect, 1);
+        }
+        double built = nowMs();
+
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        game->drawFrame(renderer, packet);
+        SDL_RenderPresent(renderer);
+        double drawn = nowMs();
+
+        updateTimes.add(updated - start);
+        tickTimes.add(ticked - updated);
+        buildTimes.add(built - ticked);
+        drawTimes.add(drawn - built);
+        frameTimes.add(drawn - start);
+        drawCalls = game->getDrawCalls();
+    }
+
+    // Calls: individual functions on their own
+    Samples guiTimes, textTimes, changingTextTimes, cachedTextTimes, uncachedTextTimes, copyTimes;
+    for (int n = 0; n < calls; n++) {
+        FramePacket packet;
+        double start = nowMs();
+        game->updateGUI(packet);
+        guiTimes.add(nowMs() - start);
+
+        SDL_Rect rect = { 20, 8, 0, 0 };
+        start = nowMs();
+        game->renderText(renderer, "Player 1: 3", rect);
+        textTimes.add(nowMs() - start);
+
+        rect = { 20, 40, 0, 0 };
+        start = nowMs();
+        game->renderText(renderer, "Player 2: " + std::to_string(n), rect);
+        changingTextTimes.add(nowMs() - start);
+
+        // Latin-1 text is not in the glyph atlas, so these go through the TextCache
+        rect = { 20, 72, 0, 0 };
+        start = nowMs();
+        game->renderText(renderer, "Jos\xe9: 3", rect);
+        cachedTextTimes.add(nowMs() - start);
+
+        rect = { 20, 104, 0, 0 };
+        start = nowMs();
+        game->renderText(renderer, "Jos\xe9: " + std::to_string(n), rect);
+        uncachedTextTimes.add(nowMs() - start);
+        game->endTextFrame();  // Each call is a frame, so old strings are evicted as they would be in the game
+
+        rect = { n % 780, 300, 20, 20 };
+        start = nowMs();
+        SDL_RenderCopy(renderer, ballSprite.texture, &ballSprite.source, &rect);
+        copyTimes.add(nowMs() - start);
+    }
+
+    int sprites = 4 + extraSprites;
+    std::cout << "Software renderer, 800x600, " << frames << " frames, " << sprites << " sprites per frame, "
+              << drawCalls << " draw calls per frame, assets loaded in " << loadMs << " ms" << std::endl;
+    std::cout << "Per frame:" << std::endl;
+    report("total", frameTimes);
+    report("update()", updateTimes);
+    report("tick()", tickTimes);
+    report("buildFrame() incl. updateGUI()", buildTimes);
+    report("drawFrame() + present", drawTimes);
+    std::cout << "  per sprite drawn: " << drawTimes.mean() * 1000 / sprites << " us" << std::endl;
+    std::cout << "Per call (" << calls << " calls each):" << std::endl;
+    report("updateGUI()", guiTimes);
+    report("renderText() glyph atlas same string", textTimes);
+    report("renderText() glyph atlas new string", changingTextTimes);
+    report("renderText() TextCache same string", cachedTextTimes);
+    report("renderText() TextCache new string", uncachedTextTimes);
+    report("SDL_RenderCopy() one sprite", copyTimes);
+
+    game->destroyTextures();
+    delete game;
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    SDL_Quit();
+    return 0;
+}
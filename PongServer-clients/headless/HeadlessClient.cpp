@@ -0,0 +1,234 @@
+// Headless client.
+// Runs complete client sessions without a window, renderer or audio device, for soak tests and
+// bot fleets on machines without a display. Each session is a GameSession like the one the
+// game draws: it connects, handshakes, takes in snapshots, predicts its paddle and the ball,
+// and sends the inputs of a scripted key sequence or of a bot (see BotController.h). Any
+// number of sessions share one process; their connections are spread over a few network
+// threads, and the main thread runs update() and the fixed ticks of every session.
+// Per-session figures are printed at the end.
+//
+// Usage: HeadlessClient [--sessions 1] [--host localhost] [--port 55555] [--shm NAME]
+//                       [--duration 0] [--script W:500,S:500,-:1000] [--stagger 250]
+//                       [--bot perfect|human|idle|toggle] [--tick-rate 60] [--threads 1] [--verbose]
+
+#include "SDL_net.h"
+#include "BotController.h"
+#include "GameSession.h"
+#include "InputScript.h"
+#include "NetClient.h"
+#include "Timing.h"
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Longest the sessions catch up on after a stall, as in the game loop
+static const double MAX_FRAME_MS = 250;
+
+// HeadlessSession: one client session and the input being fed to it
+struct HeadlessSession {
+    GameSession game;
+    std::unique_ptr<NetClient> client;
+    BotController bot;        // Plays instead of the script when given a behaviour
+    double accumulator = 0;   // Real time not yet simulated (ms)
+    double scriptOffsetMs = 0;  // Where in the script this session starts, so sessions don't move in step
+    int held = 0;             // Buttons held now
+    int ticks = 0;            // Ticks simulated
+};
+
+static std::atomic<bool> running{ true };
+
+static void onSignal(int) {
+    running = false;
+}
+
+// Network thread: runs the sessions assigned to one event loop
+static int run_network(void* loop_ptr) {
+    EventLoop* loop = (EventLoop*)loop_ptr;
+    loop->run();
+    return 0;
+}
+
+static void printSession(int index, HeadlessSession& session) {
+    GameData data = session.game.getGameData();
+    const SessionInfo& info = session.client->getSession();
+    LinkStats links = session.client->getLinkStats();
+    std::cout << "  #" << index << ": slot " << info.playerSlot << ", " << session.game.getSnapshotsReceived()
+              << " snapshots, " << session.ticks << " ticks, RTT " << session.game.getRtt() << " ms, input margin "
+              << session.game.getInputMargin() << " ms, " << session.game.getBallCorrections() << " ball corrections, "
+              << session.game.getEffectsPlayed() << " effects, score " << data.player1Score << "-" << data.player2Score
+              << ", " << links.linksLost << " links lost, " << links.reconnects << " reconnects (last took "
+              << links.lastRecoveryMs << " ms, longest " << links.maxRecoveryMs << " ms)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int sessionCount = 1;
+    int threadCount = 1;
+    double durationS = 0;   // 0 = until interrupted
+    double staggerMs = 250;
+    int tickRate = 0;       // 0 = the client default
+    bool verbose = false;
+    std::string scriptText = "W:500,S:500,-:1000";
+    std::string botName;
+    ConnectionConfig config;
+    config.cipherKey = CIPHER_KEY;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc) {
+            sessionCount = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = std::max(1, atoi(argv[++i]));  // Network threads the connections are spread over
+        }
+        else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            config.host = argv[++i];
+        }
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            config.port = (Uint16)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            config.shmName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            durationS = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            scriptText = argv[++i];
+        }
+        else if (strcmp(argv[i], "--bot") == 0 && i + 1 < argc) {
+            botName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stagger") == 0 && i + 1 < argc) {
+            staggerMs = atof(argv[++i]);  // Script offset between consecutive sessions
+        }
+        else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tickRate = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;  // Keep each session's periodic latency lines
+        }
+    }
+
+    InputScript script;
+    if (!script.parse(scriptText)) {
+        return 1;
+    }
+    if (!botName.empty() && !BotController::create(botName, 0)) {
+        std::cerr << "Unknown bot \"" << botName << "\" (perfect, human, idle or toggle)" << std::endl;
+        return 1;
+    }
+    if (SDL_Init(0) == -1) {
+        std::cerr << "SDL_Init: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    if (SDLNet_Init() == -1) {
+        std::cerr << "SDLNet_Init: " << SDLNet_GetError() << std::endl;
+        return 2;
+    }
+    if (config.shmName.empty() && !raiseSocketLimit(sessionCount)) {
+        std::cerr << "The descriptor limit is too low for " << sessionCount << " TCP sessions; raise it (ulimit -n) or run several HeadlessClient processes" << std::endl;
+        SDLNet_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // Sessions are dealt out over the loops, one thread each
+    threadCount = std::min(threadCount, sessionCount);
+    std::vector<std::unique_ptr<EventLoop>> loops;
+    for (int i = 0; i < threadCount; i++) {
+        loops.push_back(std::make_unique<EventLoop>());
+    }
+
+    std::vector<std::unique_ptr<HeadlessSession>> sessions;
+    for (int i = 0; i < sessionCount; i++) {
+        auto session = std::make_unique<HeadlessSession>();
+        if (tickRate > 0) {
+            session->game.setTickRate(tickRate);
+        }
+        if (!verbose) {
+            session->game.latencyLogIntervalMs = 0;
+            session->game.rollbackLogIntervalMs = 0;
+        }
+        session->game.startup.begin();
+        session->scriptOffsetMs = i * staggerMs;
+        if (!botName.empty()) {
+            session->bot.setBehaviour(BotController::create(botName, (unsigned)i + 1));
+        }
+        session->client = std::make_unique<NetClient>(*loops[i % threadCount], &session->game, config);
+        loops[i % threadCount]->spawn(session->client->run());
+        sessions.push_back(std::move(session));
+    }
+
+    std::vector<SDL_Thread*> threads;
+    for (auto& loop : loops) {
+        threads.push_back(SDL_CreateThread(run_network, "NetworkThread", loop.get()));
+    }
+    std::cout << "Running " << sessionCount << " sessions on " << threadCount << " network threads against "
+              << (config.shmName.empty() ? config.host + ":" + std::to_string(config.port) : "shm " + config.shmName)
+              << (durationS > 0 ? " for " + std::to_string(durationS) + " s" : " until interrupted") << std::endl;
+
+    // The game loop without drawing: every session takes in its server data, then runs the
+    // ticks the elapsed time covers with its scripted or bot keys held
+    double startTime = nowMs();
+    double previousTime = startTime;
+    double passMs = sessions.front()->game.getTickMs();
+    while (running && (durationS <= 0 || nowMs() - startTime < durationS * 1000)) {
+        double now = nowMs();
+        double elapsed = std::min(now - previousTime, MAX_FRAME_MS);
+        previousTime = now;
+
+        for (auto& session : sessions) {
+            if (session->bot.isActive()) {
+                session->bot.update(session->game, now);
+            }
+            else {
+                pressButtons(session->game, session->held, script.buttonsAt(now - startTime + session->scriptOffsetMs));
+            }
+            session->game.update();
+
+            session->accumulator += elapsed;
+            double tickMs = session->game.getTickMs();
+            while (session->accumulator >= tickMs) {
+                if (!session->game.tick()) {
+                    session->accumulator = 0;
+                    break;
+                }
+                session->accumulator -= tickMs;
+                session->ticks++;
+            }
+        }
+
+        double wait = passMs - (nowMs() - now);
+        if (wait >= 1) {
+            SDL_Delay((Uint32)wait);
+        }
+    }
+
+    for (auto& session : sessions) {
+        session->client->stop();
+    }
+    for (SDL_Thread* thread : threads) {
+        SDL_WaitThread(thread, nullptr);
+    }
+
+    std::cout << "Sessions after " << (nowMs() - startTime) / 1000 << " s:" << std::endl;
+    int connected = 0;
+    long snapshots = 0;
+    for (size_t i = 0; i < sessions.size(); i++) {
+        printSession((int)i, *sessions[i]);
+        connected += sessions[i]->game.startup.has("connected and handshake finished") ? 1 : 0;
+        snapshots += sessions[i]->game.getSnapshotsReceived();
+    }
+    std::cout << connected << " of " << sessionCount << " sessions connected, " << snapshots << " snapshots in total" << std::endl;
+
+    sessions.clear();
+    loops.clear();
+    SDLNet_Quit();
+    SDL_Quit();
+    return connected == sessionCount ? 0 : 1;
+}
@@ -0,0 +1,640 @@
+// Server load generator.
+// Opens many concurrent client sessions on the client's own network code (NetClient, Channel,
+// the handshake and the cipher), brings them up gradually, and has each one press W and S
+// the way a person does: short holds with rests in between, sent as one INPUT per tick like
+// the game, or as legacy W_DOWN/W_UP/S_DOWN/S_UP key events. Every GAME_DATA is timestamped on
+// arrival and checked. While it runs it prints the connected sessions and snapshot rate; at the
+// end it reports throughput, snapshot inter-arrival time and jitter, input latency percentiles
+// and the errors seen. Only a server on this machine is accepted.
+//
+// Input latency runs from queuing an INPUT to the first GAME_DATA that acknowledges it. Key
+// events carry no sequence number, so with --keys it runs from queuing the event to the first
+// GAME_DATA in which our paddle starts, stops or turns as the keys say it should.
+// The server only applies the inputs of the two players, so input latency comes from the
+// sessions that got a paddle; the rest are spectators that still receive every snapshot.
+// A lost session is an error; with --reconnect it also resumes, and the summary says how long
+// that took.
+// Each TCP session takes a descriptor, so the process's soft limit is raised to fit them.
+//
+// Usage: LoadGen [--sessions 100] [--ramp 10] [--duration 60] [--threads 4] [--host localhost]
+//                [--port 55555] [--shm NAME] [--keys] [--reconnect] [--report 5] [--seed 1]
+
+#include "SDL_net.h"
+#include "NetClient.h"
+#include "PaddlePredictor.h"
+#include "Timing.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+// Positions outside this are not from a working server. Generous: the server lets a paddle
+// run past the bottom of the court (PlayerCharacterComponent checks the app width)
+static const double COURT_MIN = -200;
+static const double COURT_MAX = 1000;
+
+// Human-like key presses: a key is held for HOLD_MS, then nothing for REST_MS (uniform ranges);
+// sometimes the other key is pressed straight away instead of resting
+static const double HOLD_MIN_MS = 80;
+static const double HOLD_MAX_MS = 600;
+static const double REST_MIN_MS = 150;
+static const double REST_MAX_MS = 1200;
+static const double SWITCH_CHANCE = 0.2;
+
+static const int MAX_CATCH_UP_TICKS = 5;   // Ticks sent at once after the loop fell behind
+static const size_t MAX_UNACKED = 1000;    // Inputs or key events remembered for the input latency
+
+// Histogram: fixed 0.1 ms buckets up to 2 s, so millions of samples cost no memory
+struct Histogram {
+    static constexpr int BUCKETS = 20000;
+    static constexpr double BUCKET_MS = 0.1;
+
+    std::vector<Uint64> counts = std::vector<Uint64>(BUCKETS + 1);  // The last bucket takes everything longer
+    Uint64 total = 0;
+    double sum = 0;
+    double max = 0;
+
+    void add(double ms) {
+        ms = std::max(0.0, ms);
+        counts[std::min(BUCKETS, (int)(ms / BUCKET_MS))]++;
+        total++;
+        sum += ms;
+        max = std::max(max, ms);
+    }
+
+    void merge(const Histogram& other) {
+        for (int i = 0; i <= BUCKETS; i++) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        max = std::max(max, other.max);
+    }
+
+    double mean() const { return total > 0 ? sum / total : 0; }
+
+    double percentile(double p) const {
+        if (total == 0) {
+            return 0;
+        }
+        Uint64 rank = (Uint64)std::ceil(p * total);
+        Uint64 seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return (i + 0.5) * BUCKET_MS;
+            }
+        }
+        return max;
+    }
+};
+
+// Why a GAME_DATA was rejected
+enum SnapshotError {
+    SNAPSHOT_MALFORMED,      // Too few fields, or a field that is not a number
+    SNAPSHOT_OUT_OF_RANGE,   // Positions off the court, negative scores
+    SNAPSHOT_WRONG_SLOT,     // Player slot differs from the one the handshake gave us
+    SNAPSHOT_OUT_OF_ORDER,   // Server tick did not increase
+    SNAPSHOT_ACK_REGRESSED,  // Acknowledged input went back
+    SNAPSHOT_ERROR_COUNT
+};
+
+static const char* SNAPSHOT_ERROR_NAMES[SNAPSHOT_ERROR_COUNT] = {
+    "malformed", "out of range", "wrong slot", "out of order", "ack went back"
+};
+
+// LoadStats: what the sessions of one network thread measured. Written on that thread,
+// read by the main thread for the reports
+struct LoadStats {
+    std::mutex mutex;
+    Histogram interArrival;  // Between consecutive GAME_DATA of a session (ms)
+    Histogram jitter;        // |inter-arrival - tick length| (ms)
+    Histogram ackLatency;    // INPUT or key event queued to the first GAME_DATA that shows it applied (ms)
+    Uint64 snapshots = 0;
+    Uint64 messages = 0;
+    Uint64 bytes = 0;        // Payload of the received messages
+    Uint64 inputs = 0;       // INPUTs or key events sent
+    Uint64 unackedDropped = 0;  // Inputs or key events forgotten before they showed
+    Uint64 errors[SNAPSHOT_ERROR_COUNT] = {};
+    int connected = 0;       // Sessions that finished a handshake at least once
+    int players = 0;         // ...and got a paddle
+};
+
+static bool parseNumber(const std::string& text, double& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return end == text.c_str() + text.length() && std::isfinite(value);
+}
+
+// LoadSession: one simulated player. Everything but the stats runs on its network thread
+class LoadSession : public SessionHandler {
+private:
+    LoadStats* stats;
+    bool legacyKeys;
+    std::mt19937 random;
+
+    int slot = -1;             // From the handshake
+    bool everConnected = false;
+    double tickMs = 1000.0 / PaddleRules::TICK_RATE;
+
+    // Incoming snapshots
+    double lastArrival = -1;
+    double lastServerTick = -1;
+    double lastAck = 0;
+
+    // Outgoing input
+    int buttons = 0;           // Held now
+    int lastSentButtons = 0;
+    double nextChange = -1;    // When the held keys change next (nowMs())
+    double nextTick = -1;      // When the next tick's input is due
+    Uint32 seq = 0;
+    std::deque<std::pair<Uint32, double>> unacked;  // Sequence number and time queued
+
+    // Key events: the paddle's movement in the snapshots, and the movement each event should cause
+    double paddleY = -1;       // Our paddle in the latest snapshot (-1 = none yet)
+    int paddleDirection = 0;   // -1 up, 1 down, 0 still, from the last two snapshots
+    std::deque<std::pair<int, double>> keyChanges;  // Expected direction and time queued
+
+    double uniform(double low, double high) { return std::uniform_real_distribution<double>(low, high)(random); }
+
+    void pressKeys(double now);
+    SnapshotError validate(std::vector<std::string>& args, double values[]);
+
+public:
+    LoadSession(LoadStats* stats, bool legacyKeys, unsigned seed) : stats(stats), legacyKeys(legacyKeys), random(seed) {}
+
+    void on_session(const SessionInfo& session) override;
+    void on_receive(std::string cmd, std::vector<std::string>& args) override;
+    bool takeMessages(std::vector<std::string>& messages) override;
+    Uint32 msUntilMessages() override;
+};
+
+void LoadSession::on_session(const SessionInfo& session) {
+    slot = session.playerSlot;
+    if (session.tickRate > 0) {
+        tickMs = 1000.0 / session.tickRate;
+    }
+
+    // A new connection starts a new stream of snapshots and acks
+    lastArrival = -1;
+    lastServerTick = -1;
+    lastAck = 0;
+    unacked.clear();
+    nextTick = -1;
+    paddleY = -1;
+    paddleDirection = 0;
+    keyChanges.clear();
+
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    if (!everConnected) {
+        everConnected = true;
+        stats->connected++;
+        stats->players += slot == 1 || slot == 2 ? 1 : 0;
+    }
+}
+
+// GAME_DATA,<p1 y>,<p2 y>,<ball x>,<ball y>,<p1 x>,<p2 x>,<slot>,<score 1>,<score 2>
+//           [,<ack>[,<ball vx>,<ball vy>[,<server tick>,<server time>[,<input margin>]]]]
+SnapshotError LoadSession::validate(std::vector<std::string>& args, double values[]) {
+    if (args.size() < 9 || args.size() > 15) {
+        return SNAPSHOT_MALFORMED;
+    }
+    for (size_t i = 0; i < args.size(); i++) {
+        if (!parseNumber(args[i], values[i])) {
+            return SNAPSHOT_MALFORMED;
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        if (values[i] < COURT_MIN || values[i] > COURT_MAX) {
+            return SNAPSHOT_OUT_OF_RANGE;
+        }
+    }
+    if (values[7] < 0 || values[8] < 0) {
+        return SNAPSHOT_OUT_OF_RANGE;
+    }
+    if (slot >= 0 && (int)values[6] != slot) {
+        return SNAPSHOT_WRONG_SLOT;
+    }
+    if (args.size() >= 13) {
+        if (values[12] <= lastServerTick) {
+            return SNAPSHOT_OUT_OF_ORDER;
+        }
+        lastServerTick = values[12];
+    }
+    if (args.size() >= 10) {
+        if (values[9] < lastAck) {
+            return SNAPSHOT_ACK_REGRESSED;
+        }
+        lastAck = values[9];
+    }
+    return SNAPSHOT_ERROR_COUNT;
+}
+
+void LoadSession::on_receive(std::string cmd, std::vector<std::string>& args) {
+    double arrival = nowMs();
+    size_t length = cmd.length();
+    for (const std::string& arg : args) {
+        length += arg.length() + 1;
+    }
+
+    if (cmd != "GAME_DATA") {
+        std::lock_guard<std::mutex> lock(stats->mutex);
+        stats->messages++;
+        stats->bytes += length;
+        return;
+    }
+
+    double values[15];
+    SnapshotError error = validate(args, values);
+
+    // Inputs acknowledged for the first time by this snapshot
+    std::vector<double> acked;
+    if (error == SNAPSHOT_ERROR_COUNT && args.size() >= 10) {
+        while (!unacked.empty() && unacked.front().first <= (Uint32)values[9]) {
+            acked.push_back(arrival - unacked.front().second);
+            unacked.pop_front();
+        }
+    }
+
+    // Key events whose movement this snapshot shows. Earlier ones that never showed (a tap
+    // shorter than a tick) are overtaken by it and dropped
+    if (error == SNAPSHOT_ERROR_COUNT && (slot == 1 || slot == 2)) {
+        double y = values[slot - 1];
+        if (paddleY >= 0) {
+            paddleDirection = y < paddleY ? -1 : y > paddleY ? 1 : 0;
+            for (size_t i = 0; i < keyChanges.size(); i++) {
+                if (keyChanges[i].first == paddleDirection) {
+                    acked.push_back(arrival - keyChanges[i].second);
+                    keyChanges.erase(keyChanges.begin(), keyChanges.begin() + i + 1);
+                    break;
+                }
+            }
+        }
+        paddleY = y;
+    }
+
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    stats->messages++;
+    stats->bytes += length;
+    stats->snapshots++;
+    if (error != SNAPSHOT_ERROR_COUNT) {
+        stats->errors[error]++;
+    }
+    if (lastArrival >= 0) {
+        double gap = arrival - lastArrival;
+        stats->interArrival.add(gap);
+        stats->jitter.add(std::fabs(gap - tickMs));
+    }
+    lastArrival = arrival;
+    for (double latency : acked) {
+        stats->ackLatency.add(latency);
+    }
+}
+
+// Hold a key for a moment, let go, rest, press again
+void LoadSession::pressKeys(double now) {
+    if (now < nextChange) {
+        return;
+    }
+    if (nextChange < 0) {
+        nextChange = now + uniform(0, REST_MAX_MS);  // Sessions start out of step
+        return;
+    }
+    if (buttons == 0 || uniform(0, 1) < SWITCH_CHANCE) {
+        int other = buttons == PaddleRules::UP ? PaddleRules::DOWN : PaddleRules::UP;
+        buttons = buttons == 0 ? (uniform(0, 1) < 0.5 ? PaddleRules::UP : PaddleRules::DOWN) : other;
+        nextChange = now + uniform(HOLD_MIN_MS, HOLD_MAX_MS);
+    }
+    else {
+        buttons = 0;
+        nextChange = now + uniform(REST_MIN_MS, REST_MAX_MS);
+    }
+}
+
+// Called by the network thread whenever it can send: queue the inputs that have come due
+bool LoadSession::takeMessages(std::vector<std::string>& messages) {
+    if (slot < 0) {
+        return false;  // Not through the handshake yet
+    }
+    double now = nowMs();
+    pressKeys(now);
+    int sent = 0;
+
+    if (legacyKeys) {
+        // Key events on every change, as the original client sent them
+        int changed = buttons ^ lastSentButtons;
+        if (changed & PaddleRules::UP) {
+            messages.push_back(buttons & PaddleRules::UP ? "W_DOWN" : "W_UP");
+            sent++;
+        }
+        if (changed & PaddleRules::DOWN) {
+            messages.push_back(buttons & PaddleRules::DOWN ? "S_DOWN" : "S_UP");
+            sent++;
+        }
+        lastSentButtons = buttons;
+
+        // Time the change only if the paddle should visibly react: not a key held against a wall
+        if (changed != 0 && (slot == 1 || slot == 2) && paddleY >= 0) {
+            float moved = PaddleRules::step((float)paddleY, buttons) - (float)paddleY;
+            int direction = moved < 0 ? -1 : moved > 0 ? 1 : 0;
+            if (direction != paddleDirection) {
+                keyChanges.emplace_back(direction, now);
+            }
+        }
+    }
+    else {
+        // One INPUT per tick while a key is held and one for the release, like the game
+        if (nextTick < 0) {
+            nextTick = now;
+        }
+        for (int due = 0; now >= nextTick && due < MAX_CATCH_UP_TICKS; due++) {
+            seq++;
+            nextTick += tickMs;
+            if (buttons == 0 && lastSentButtons == 0) {
+                continue;
+            }
+            messages.push_back("INPUT," + std::to_string(seq) + "," + std::to_string(buttons));
+            lastSentButtons = buttons;
+            sent++;
+            if (slot == 1 || slot == 2) {
+                unacked.emplace_back(seq, now);  // Spectators' inputs are never applied
+            }
+        }
+        if (now >= nextTick) {
+            nextTick = now + tickMs;  // Too far behind: skip the missed ticks
+        }
+    }
+
+    size_t dropped = 0;
+    while (unacked.size() > MAX_UNACKED) {
+        unacked.pop_front();
+        dropped++;
+    }
+    while (keyChanges.size() > MAX_UNACKED) {
+        keyChanges.pop_front();
+        dropped++;
+    }
+    if (sent > 0 || dropped > 0) {
+        std::lock_guard<std::mutex> lock(stats->mutex);
+        stats->inputs += sent;
+        stats->unackedDropped += dropped;
+    }
+    return sent > 0;
+}
+
+// Inputs are made up on the spot rather than queued, so the send loop is told when to ask next
+Uint32 LoadSession::msUntilMessages() {
+    if (slot < 0) {
+        return EventLoop::FOREVER;  // on_session comes first
+    }
+    double due = legacyKeys ? nextChange : std::min(nextChange, nextTick);
+    double wait = due - nowMs();
+    return due < 0 || wait <= 0 ? 0 : (Uint32)std::ceil(wait);  // Negative: not started, so ask at once
+}
+
+static std::atomic<bool> running{ true };
+
+static void onSignal(int) {
+    running = false;
+}
+
+// Network thread: runs the sessions of one event loop
+static int run_network(void* loop_ptr) {
+    EventLoop* loop = (EventLoop*)loop_ptr;
+    loop->run();
+    return 0;
+}
+
+// Start a session after its place in the ramp-up
+static Task<> startSession(EventLoop* loop, NetClient* client, Uint32 delayMs, CancelToken* cancel) {
+    if (delayMs > 0 && !co_await loop->sleep(delayMs, cancel)) {
+        co_return;
+    }
+    Task<> session = client->run();  // Named: GCC destroys a temporary awaited task too early
+    co_await session;
+}
+
+// Loopback only: the tool must never be pointed at someone else's server
+static bool isLocalHost(const std::string& host) {
+    IPaddress address;
+    if (SDLNet_ResolveHost(&address, host.c_str(), 0) != 0) {
+        return false;
+    }
+    Uint32 ip = SDLNet_Read32(&address.host);
+    return (ip >> 24) == 127;
+}
+
+// Totals of every network thread's stats
+static void collect(std::vector<std::unique_ptr<LoadStats>>& all, LoadStats& total) {
+    for (auto& stats : all) {
+        std::lock_guard<std::mutex> lock(stats->mutex);
+        total.interArrival.merge(stats->interArrival);
+        total.jitter.merge(stats->jitter);
+        total.ackLatency.merge(stats->ackLatency);
+        total.snapshots += stats->snapshots;
+        total.messages += stats->messages;
+        total.bytes += stats->bytes;
+        total.inputs += stats->inputs;
+        total.unackedDropped += stats->unackedDropped;
+        for (int i = 0; i < SNAPSHOT_ERROR_COUNT; i++) {
+            total.errors[i] += stats->errors[i];
+        }
+        total.connected += stats->connected;
+        total.players += stats->players;
+    }
+}
+
+static void report(const char* name, const Histogram& histogram) {
+    std::cout << "  " << name << ": p50 " << histogram.percentile(0.5) << " ms, p90 " << histogram.percentile(0.9)
+              << " ms, p99 " << histogram.percentile(0.99) << " ms, p99.9 " << histogram.percentile(0.999)
+              << " ms, max " << histogram.max << " ms (mean " << histogram.mean() << " ms over " << histogram.total
+              << ")" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int sessionCount = 100;
+    int threadCount = 4;
+    double rampS = 10;       // Time over which the sessions are started
+    double durationS = 60;   // 0 = until interrupted
+    double reportS = 5;      // Progress line interval (0 = none)
+    unsigned seed = 1;
+    bool legacyKeys = false;
+    ConnectionConfig config;
+    config.cipherKey = CIPHER_KEY;
+    config.reconnect = false;  // A lost session is an error to report, not to hide
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc) {
+            sessionCount = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--ramp") == 0 && i + 1 < argc) {
+            rampS = std::max(0.0, atof(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            durationS = atof(argv[++i]);  // Counted from the start of the ramp
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            config.host = argv[++i];
+        }
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            config.port = (Uint16)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            config.shmName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--keys") == 0) {
+            legacyKeys = true;  // W_DOWN/W_UP/S_DOWN/S_UP instead of INPUT, timed by the paddle's movement
+        }
+        else if (strcmp(argv[i], "--reconnect") == 0) {
+            config.reconnect = true;  // Resume lost sessions; each loss still counts as an error
+        }
+        else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            reportS = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned)atoi(argv[++i]);
+        }
+    }
+
+    if (SDL_Init(0) == -1) {
+        std::cerr << "SDL_Init: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    if (SDLNet_Init() == -1) {
+        std::cerr << "SDLNet_Init: " << SDLNet_GetError() << std::endl;
+        return 2;
+    }
+    if (config.shmName.empty() && !isLocalHost(config.host)) {
+        std::cerr << config.host << " is not this machine; LoadGen only runs against a local server" << std::endl;
+        SDLNet_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    if (config.shmName.empty() && !raiseSocketLimit(sessionCount)) {
+        std::cerr << "The descriptor limit is too low for " << sessionCount << " TCP sessions; raise it (ulimit -n) or run several LoadGen processes" << std::endl;
+        SDLNet_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    threadCount = std::min(threadCount, sessionCount);
+    std::vector<std::unique_ptr<EventLoop>> loops;
+    std::vector<std::unique_ptr<LoadStats>> stats;
+    for (int i = 0; i < threadCount; i++) {
+        loops.push_back(std::make_unique<EventLoop>());
+        stats.push_back(std::make_unique<LoadStats>());
+    }
+
+    // Session i starts i/N of the way through the ramp
+    CancelToken rampCancel;
+    std::vector<std::unique_ptr<LoadSession>> sessions;
+    std::vector<std::unique_ptr<NetClient>> clients;
+    for (int i = 0; i < sessionCount; i++) {
+        EventLoop& loop = *loops[i % threadCount];
+        sessions.push_back(std::make_unique<LoadSession>(stats[i % threadCount].get(), legacyKeys, seed + i));
+        clients.push_back(std::make_unique<NetClient>(loop, sessions.back().get(), config));
+        Uint32 delayMs = (Uint32)(rampS * 1000 * i / sessionCount);
+        loop.spawn(startSession(&loop, clients.back().get(), delayMs, &rampCancel));
+    }
+
+    std::vector<SDL_Thread*> threads;
+    for (auto& loop : loops) {
+        threads.push_back(SDL_CreateThread(run_network, "NetworkThread", loop.get()));
+    }
+    std::cout << "Starting " << sessionCount << " sessions over " << rampS << " s on " << threadCount << " network threads against "
+              << (config.shmName.empty() ? config.host + ":" + std::to_string(config.port) : "shm " + config.shmName)
+              << (legacyKeys ? " with key events" : " with per-tick inputs") << std::endl;
+
+    double startTime = nowMs();
+    double lastReport = startTime;
+    Uint64 lastSnapshots = 0;
+    while (running && (durationS <= 0 || nowMs() - startTime < durationS * 1000)) {
+        SDL_Delay(100);
+        double now = nowMs();
+        if (reportS > 0 && now - lastReport >= reportS * 1000) {
+            LoadStats total;
+            collect(stats, total);
+            Uint64 errors = 0;
+            for (Uint64 count : total.errors) {
+                errors += count;
+            }
+            std::cout << (int)((now - startTime) / 1000) << " s: " << total.connected << " sessions connected, "
+                      << (Uint64)((total.snapshots - lastSnapshots) * 1000 / (now - lastReport)) << " GAME_DATA/s, "
+                      << errors << " bad snapshots" << std::endl;
+            lastReport = now;
+            lastSnapshots = total.snapshots;
+        }
+    }
+    double elapsedS = (nowMs() - startTime) / 1000;
+
+    rampCancel.cancel();
+    for (auto& client : clients) {
+        client->stop();
+    }
+    for (SDL_Thread* thread : threads) {
+        SDL_WaitThread(thread, nullptr);
+    }
+
+    LoadStats total;
+    collect(stats, total);
+    int failedConnects = 0;
+    int linksLost = 0;
+    int reconnects = 0;
+    int recovered = 0;             // Sessions that recovered at least once
+    double lastRecoverySum = 0;    // Their last recovery times, for the mean
+    Uint32 maxRecoveryMs = 0;
+    for (auto& client : clients) {
+        LinkStats links = client->getLinkStats();
+        failedConnects += links.failedAttempts;
+        linksLost += links.linksLost;
+        reconnects += links.reconnects;
+        if (links.reconnects > 0) {
+            recovered++;
+            lastRecoverySum += links.lastRecoveryMs;
+            maxRecoveryMs = std::max(maxRecoveryMs, links.maxRecoveryMs);
+        }
+    }
+
+    std::cout << "LoadGen: " << sessionCount << " sessions, " << total.connected << " connected (" << total.players
+              << " with a paddle), " << elapsedS << " s" << std::endl;
+    std::cout << "  Throughput: " << total.snapshots / elapsedS << " GAME_DATA/s, " << total.messages / elapsedS
+              << " messages/s, " << total.bytes / elapsedS / 1024 << " KB/s received, " << total.inputs / elapsedS
+              << " inputs/s sent" << std::endl;
+    report("Snapshot inter-arrival", total.interArrival);
+    report("Jitter (|inter-arrival - tick|)", total.jitter);
+    report(legacyKeys ? "Key to paddle movement" : "Input to ack", total.ackLatency);
+    std::cout << "  Recovery: " << reconnects << " reconnects in " << recovered << " sessions, last recovery mean "
+              << (recovered > 0 ? lastRecoverySum / recovered : 0) << " ms, longest " << maxRecoveryMs << " ms" << std::endl;
+
+    Uint64 errorCount = failedConnects + linksLost + (sessionCount - total.connected);
+    std::cout << "  Errors:";
+    for (int i = 0; i < SNAPSHOT_ERROR_COUNT; i++) {
+        std::cout << " " << SNAPSHOT_ERROR_NAMES[i] << " " << total.errors[i] << ",";
+        errorCount += total.errors[i];
+    }
+    std::cout << " failed connects " << failedConnects << ", links lost " << linksLost << ", never connected "
+              << sessionCount - total.connected << ", inputs never acked " << total.unackedDropped << std::endl;
+
+    clients.clear();
+    sessions.clear();
+    loops.clear();
+    SDLNet_Quit();
+    SDL_Quit();
+    return errorCount == 0 ? 0 : 1;
+}
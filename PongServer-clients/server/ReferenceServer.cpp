@@ -0,0 +1,922 @@
+// Headless reference server.
+// A stand-in for the Java PongApp server that runs without a display, for client latency,
+// throughput and soak benchmarks on build machines. It listens on the same port and speaks
+// the same wire protocol: HELLO/WELCOME with resume tokens, per-tick INPUTs (or the legacy
+// W_DOWN/W_UP/S_DOWN/S_UP keys), PING/PONG, HEARTBEAT and the rollback relay. The game is
+// PongSim, the client's fixed-point port of the server's rules, and each tick sends the same
+// GAME_DATA/SCORES/HIT_*/BALL_HIT_BAT* stream as PongApp, in the same order.
+//
+// The outgoing stream can be shaped to look like a real network and server: --jitter delays
+// every batch of messages by a random 0..MS, and --burst holds the per-tick messages and sends
+// N ticks of them at once. A seed makes both repeatable.
+//
+// --tick-rate sets how often the game is stepped and sent, not how fast it runs: PongSim
+// scales its per-tick speeds to the tick length, and GAME_DATA gives velocities per second.
+// Start the clients with the same --tick-rate so their prediction steps with the server. Sends never block the loop: each TCP connection queues what its socket cannot
+// take yet, and one whose unsent messages pass MAX_OUTBOX_BYTES is closed as a slow consumer.
+//
+// With --shm NAME it also hosts a shared-memory segment (see ShmTransport.h) for one client on
+// this machine at a time, next to the TCP port. The segment is created again whenever its
+// client leaves. Shared memory skips the cipher unless --cipher is given, which must match
+// the client's --cipher.
+//
+// Usage: ReferenceServer [--port 55555] [--tick-rate 60] [--jitter 0] [--burst 1] [--seed 1]
+//                        [--duration 0] [--report 5] [--shm NAME] [--cipher]
+
+#include "SDL_net.h"
+#include "Channel.h"
+#include "NativeSocket.h"
+#include "PaddlePredictor.h"
+#include "PongSim.h"
+#include "Protocol.h"
+#include "ShmTransport.h"
+#include "Timing.h"
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Limits and timeouts, as in PongApp
+static const int MAX_CONNECTIONS = 10000;       // start() raises the process's descriptor limit to fit them
+static const double CLIENT_TIMEOUT_MS = 5000;   // Connections silent this long are closed
+static const double RESUME_WINDOW_MS = 30000;   // A dropped player's slot is held this long for its token
+static const size_t MAX_BUFFERED_INPUTS = 4;    // Older inputs are skipped if a client gets this far ahead
+static const int SYNC_VALUES = 13;              // SYNC,<tick>,<rolling hash>,<11 state fields>
+static const size_t MAX_SYNC_HASHES = 1000;     // Unmatched rollback hashes kept before giving up on them
+static const double MAX_CATCH_UP_MS = 250;      // A loop further behind than this skips ticks instead of running them
+static const double SHM_POLL_MS = 1;            // Shared memory has no socket to wake poll(), so it is polled
+static const int SEND_QUEUE_BYTES = 16384;      // Written to a TCP connection's transport beyond what its socket takes
+static const size_t MAX_OUTBOX_BYTES = 65536;   // Unsent messages a connection may build up (~7 s of GAME_DATA)
+
+// What this server implements; the cipher is always on, as on the Java server
+static const int SERVER_CAPABILITIES = CAP_CIPHER;
+
+// Outgoing: a message waiting for its release time
+struct Outgoing {
+    double releaseAt;
+    std::string message;
+};
+
+// Connection: one client socket and what the server knows about it
+struct Connection {
+    int number = 0;                     // Connection number, from 1 in order of arrival
+    std::unique_ptr<Channel> channel;
+    bool hasSlot = false;               // Assigned a slot by HELLO
+    int slot = 0;                       // 1 or 2 for players, 0 for spectators
+    std::string token;                  // Resume token given in WELCOME
+    double lastHeard = 0;               // Time of the last message received
+    bool closed = false;                // Failed or closed; removed at the end of the pass
+    int pollIndex = -1;                 // Its socket's entry in this pass's poller; -1 on shared memory
+
+    std::vector<std::string> held;      // Per-tick messages kept back until the burst is sent
+    std::deque<Outgoing> outbox;        // Messages released at or after their time, in order
+    size_t outboxBytes = 0;             // Length of the messages in outbox
+    int sendQueued = 0;                 // Bytes waiting in the transport's send queue after the last flush
+    double lastReleaseAt = 0;           // Release time of the newest message, so jitter never reorders
+
+    SocketHandle socket() const { return channel->getTransport()->nativeSocket(); }  // NO_SOCKET on shared memory
+};
+
+// QueuedInput: an INPUT waiting for the tick that applies it
+struct QueuedInput {
+    int seq;
+    int buttons;
+    double arrival;
+};
+
+// PlayerInput: how a player slot is being driven
+struct PlayerInput {
+    bool usesInputs = false;           // Sent INPUTs; until then the legacy keys drive the paddle
+    std::deque<QueuedInput> pending;
+    int lastAppliedInput = 0;          // Sequence number acked in GAME_DATA
+    int lastAppliedButtons = 0;
+    int starvedTicks = 0;              // Ticks without an input while a key was held
+    double inputMargin = 0;            // ms the last input waited (positive) or was late (negative)
+    int keys = 0;                      // Held by legacy key events
+};
+
+// ServerStats: figures for the periodic report
+struct ServerStats {
+    long ticks = 0;
+    long skippedTicks = 0;     // Dropped by catching up after a stall
+    long messages = 0;
+    long bytes = 0;
+    double worstLateMs = 0;    // Longest a tick started after its time
+    long slowConsumers = 0;    // Connections closed for falling MAX_OUTBOX_BYTES behind
+};
+
+// ReferenceServer: PongApp's rules and message stream on top of PongSim
+class ReferenceServer {
+private:
+    SocketHandle listener = NO_SOCKET;
+    SocketPoller poller;       // The listener and every TCP connection, rebuilt each pass
+    std::vector<std::unique_ptr<Connection>> connections;
+    int nextConnectionNumber = 1;
+
+    PongSim sim;
+    long serverTick = 0;
+    double tickMs = 1000.0 / PongSim::TICK_RATE;
+    double nextTickAt = 0;
+    PlayerInput players[3];    // Indexed by slot; 0 is unused
+
+    std::random_device tokenSource;  // Resume tokens must not be guessable, so not the seeded generator
+    std::map<std::string, int> tokenSlots;  // Resume token -> player slot
+    double reservedUntil[3] = { 0, 0, 0 };  // Player slot -> end of its resume window
+
+    std::map<int, int> rollbackDelays;      // Player slot -> requested input delay
+    int lastRelayedFrame[3] = { -1, -1, -1 };
+    bool rollbackActive = false;
+    std::map<std::string, std::string> syncHashes;  // Tick -> first player's hash, until the other arrives
+
+    std::unique_ptr<Connection> shmWaiting;  // Hosted segment no client has spoken on yet
+    bool shmInUse = false;                   // A client holds the segment; the next is created when it leaves
+
+    std::mt19937 random;
+    ServerStats stats;
+
+    bool openShm();
+    void pollShm(double now);
+    void accept(double now);
+    void receive(Connection& connection, double now);
+    void handleMessage(Connection& connection, const std::string& cmd, const std::vector<std::string>& args, double now);
+    void handleHello(Connection& connection, const std::vector<std::string>& args, double now);
+    void joinRollback(int slot, const std::string& delay, double now);
+    void checkSync(int slot, const std::string& tick, const std::string& hash);
+    void relayFrame(int slot, const std::string& tickToken, const std::string& buttonsToken, std::string& relay);
+    void applyKey(int slot, const std::string& key);
+
+    void tick(double now);
+    int applyQueuedInput(int slot, double now);
+    std::string gameDataFor(int slot, double now) const;
+    void dropSilentConnections(double now);
+    void removeClosed(double now);
+    void disconnected(Connection& connection, double now);
+    bool isSlotTaken(int slot, double now);
+    std::string newSessionToken();
+
+    int slotOf(const Connection& connection, double now);
+    void post(Connection& connection, const std::string& message, double now);
+    void postTick(Connection& connection, const std::string& message);
+    void sendTo(int slot, const std::string& message, double now);
+    void broadcast(const std::string& message);
+    void releaseBursts(double now);
+    void flush(double now);
+    double jitterDelay();
+
+public:
+    Uint16 port = 55555;
+    int tickRate = PongSim::TICK_RATE;
+    double jitterMs = 0;       // Each batch of messages is delayed by up to this
+    int burstTicks = 1;        // Per-tick messages are sent this many ticks at a time
+    unsigned seed = 1;         // Seeds the jitter
+    double reportIntervalS = 5;  // 0 = no periodic report
+    std::string shmName;       // Shared-memory segment to host as well (empty = TCP only)
+    bool shmCipher = false;    // Keep the XOR stage on the shared-memory path
+
+    ~ReferenceServer();
+
+    bool start();
+    void run(double durationS, const std::atomic<bool>& running);
+    void printReport(double elapsedMs);
+};
+
+static bool parseInt(const std::string& text, int& value) {
+    char* end = nullptr;
+    long parsed = strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0') {
+        return false;
+    }
+    value = (int)parsed;
+    return true;
+}
+
+static std::string formatNumber(double value, const char* format = "%.10g") {
+    char text[64];
+    snprintf(text, sizeof(text), format, value);
+    return text;
+}
+
+// Send one message each way through a scratch segment, so a machine without usable shared
+// memory is reported at startup instead of when the first client attaches
+static bool checkShmLoopback(const std::string& name) {
+    std::string checkName = name + "-check";
+    std::unique_ptr<ShmTransport> host(ShmTransport::create(checkName.c_str(), 4096));
+    std::unique_ptr<ShmTransport> peer(host ? ShmTransport::attach(checkName.c_str()) : nullptr);
+    if (!peer) {
+        return false;
+    }
+    char buffer[16];
+    bool ok = host->send("HELLO", 5) == 5 && peer->recv(buffer, sizeof(buffer)) == 5 && memcmp(buffer, "HELLO", 5) == 0 &&
+              peer->send("WELCOME", 7) == 7 && host->recv(buffer, sizeof(buffer)) == 7 && memcmp(buffer, "WELCOME", 7) == 0;
+    if (!ok) {
+        std::cerr << "Shared memory loopback check on " << checkName << " failed" << std::endl;
+    }
+    return ok;
+}
+
+ReferenceServer::~ReferenceServer() {
+    connections.clear();
+    shmWaiting.reset();
+    socketClose(listener);
+}
+
+bool ReferenceServer::start() {
+    listener = socketListen(port);
+    if (listener == NO_SOCKET) {
+        std::cerr << "Could not listen on port " << port << std::endl;
+        return false;
+    }
+    if (!raiseSocketLimit(MAX_CONNECTIONS)) {
+        std::cerr << "The descriptor limit is below " << MAX_CONNECTIONS << " connections; accepts fail beyond it" << std::endl;
+    }
+    if (!shmName.empty() && (!checkShmLoopback(shmName) || !openShm())) {
+        return false;
+    }
+
+    tickMs = 1000.0 / tickRate;
+    random.seed(seed);
+    sim.setTickRate(tickRate);
+    sim.reset();
+    return true;
+}
+
+// The loop: wait for sockets until the next tick or release time, take in what arrived, run
+// the ticks that are due and send whatever has been released
+void ReferenceServer::run(double durationS, const std::atomic<bool>& running) {
+    double startTime = nowMs();
+    double lastReport = startTime;
+    nextTickAt = startTime;
+    while (running && (durationS <= 0 || nowMs() - startTime < durationS * 1000)) {
+        double now = nowMs();
+        double wakeAt = nextTickAt;
+        for (auto& connection : connections) {
+            if (!connection->outbox.empty() && connection->sendQueued == 0) {  // Otherwise WRITE wakes us
+                wakeAt = std::min(wakeAt, connection->outbox.front().releaseAt);
+            }
+        }
+
+        // poll() only sleeps whole milliseconds; the last one is polled so ticks leave on time
+        double wait = wakeAt - now;
+        if (!shmName.empty()) {
+            wait = std::min(wait, SHM_POLL_MS);
+        }
+        poller.clear();
+        poller.add(listener, SocketPoller::READ);
+        for (auto& connection : connections) {
+            int events = SocketPoller::READ | (connection->sendQueued > 0 ? SocketPoller::WRITE : 0);  // WRITE: flush as soon as it drains
+            connection->pollIndex = connection->socket() == NO_SOCKET ? -1 : poller.add(connection->socket(), events);
+        }
+        int ready = poller.wait(wait >= 1 ? (Uint32)wait : 0);
+        if (ready < 0) {
+            std::cerr << "poll() failed on " << connections.size() + 1 << " sockets" << std::endl;
+            break;
+        }
+
+        // Connections accepted now are not in the poller, so only those polled are checked
+        now = nowMs();
+        size_t polled = connections.size();
+        if (ready > 0 && poller.ready(0)) {
+            accept(now);
+        }
+        for (size_t i = 0; i < polled; i++) {
+            Connection& connection = *connections[i];
+            if (connection.pollIndex < 0 || (poller.ready(connection.pollIndex) & SocketPoller::READ) ||
+                connection.channel->hasBufferedMessage()) {
+                receive(connection, now);
+            }
+        }
+        pollShm(now);
+
+        if (now - nextTickAt > MAX_CATCH_UP_MS) {
+            long skipped = (long)((now - nextTickAt) / tickMs);
+            stats.skippedTicks += skipped;
+            nextTickAt += skipped * tickMs;
+        }
+        while (now >= nextTickAt) {
+            stats.worstLateMs = std::max(stats.worstLateMs, now - nextTickAt);
+            tick(now);
+            nextTickAt += tickMs;
+        }
+
+        flush(now);
+        removeClosed(now);
+
+        if (reportIntervalS > 0 && now - lastReport >= reportIntervalS * 1000) {
+            printReport(now - lastReport);
+            lastReport = now;
+            stats = ServerStats();
+        }
+    }
+}
+
+bool ReferenceServer::openShm() {
+    ShmTransport* transport = ShmTransport::create(shmName.c_str());
+    if (!transport) {
+        return false;
+    }
+    // Whole messages, so no framing
+    shmWaiting = std::make_unique<Connection>();
+    shmWaiting->channel = std::make_unique<Channel>(transport, false, shmCipher ? CIPHER_KEY : nullptr);
+    return true;
+}
+
+// The segment's client becomes a connection with its first message. Until then nothing is
+// sent into the segment, so a ring nobody reads never fills up
+void ReferenceServer::pollShm(double now) {
+    if (!shmWaiting) {
+        if (shmName.empty() || shmInUse || openShm()) {
+            return;
+        }
+        std::cerr << "No longer hosting shared memory " << shmName << std::endl;
+        shmName.clear();
+        return;
+    }
+
+    char* message = nullptr;
+    int length = shmWaiting->channel->tryReceiveMessage(message);
+    if (length == Channel::WOULD_BLOCK) {
+        return;
+    }
+    if (length < 0) {
+        shmWaiting.reset();  // Attached and left without a word; created again on the next pass
+        return;
+    }
+
+    Connection& connection = *shmWaiting;
+    connection.number = nextConnectionNumber++;
+    connection.lastHeard = now;
+    connections.push_back(std::move(shmWaiting));
+    shmInUse = true;
+
+    std::string cmd;
+    std::vector<std::string> args;
+    splitMessage(message, length, cmd, args);
+    handleMessage(connection, cmd, args, now);
+    receive(connection, now);
+}
+
+void ReferenceServer::accept(double now) {
+    SocketHandle socket;
+    while ((socket = socketAccept(listener)) != NO_SOCKET) {
+        if ((int)connections.size() >= MAX_CONNECTIONS) {
+            std::cerr << "Refusing a connection: already serving " << MAX_CONNECTIONS << std::endl;
+            socketClose(socket);
+            continue;
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->number = nextConnectionNumber++;
+        TcpTransport* transport = new TcpTransport(socket);
+        transport->setSendQueueLimit(SEND_QUEUE_BYTES);
+        connection->channel = std::make_unique<Channel>(transport, true, CIPHER_KEY);
+        connection->lastHeard = now;
+        connections.push_back(std::move(connection));
+    }
+}
+
+void ReferenceServer::receive(Connection& connection, double now) {
+    std::string cmd;
+    std::vector<std::string> args;
+    while (!connection.closed) {
+        char* message = nullptr;
+        int length = connection.channel->tryReceiveMessage(message);
+        if (length == Channel::WOULD_BLOCK) {
+            return;
+        }
+        if (length < 0) {
+            connection.closed = true;
+            return;
+        }
+        connection.lastHeard = now;
+        splitMessage(message, length, cmd, args);
+        handleMessage(connection, cmd, args, now);
+    }
+}
+
+// CLIENT_DATA,INPUT,<seq>,<buttons>,INPUT,... with the other client tokens in any order, as
+// PongApp.onReceive reads them
+void ReferenceServer::handleMessage(Connection& connection, const std::string& cmd, const std::vector<std::string>& args,
+                                    double now) {
+    if (cmd == "HELLO") {
+        handleHello(connection, args, now);
+        return;
+    }
+    int slot = slotOf(connection, now);
+
+    std::string relay;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "INPUT" && i + 2 < args.size()) {
+            QueuedInput input = { 0, 0, now };
+            if (slot >= 1 && slot <= 2 && parseInt(args[i + 1], input.seq) && parseInt(args[i + 2], input.buttons)) {
+                players[slot].usesInputs = true;
+                players[slot].pending.push_back(input);
+            }
+            else if (slot >= 1 && slot <= 2) {
+                std::cerr << "Bad INPUT from player " << slot << std::endl;
+            }
+            i += 2;
+        }
+        else if (args[i] == "PING" && i + 1 < args.size()) {
+            post(connection, "PONG," + args[i + 1] + "," + formatNumber(now, "%.3f") + "," + std::to_string(serverTick), now);
+            i += 1;
+        }
+        else if (args[i] == "FRAME" && i + 2 < args.size()) {
+            relayFrame(slot, args[i + 1], args[i + 2], relay);
+            i += 2;
+        }
+        else if (args[i] == "SYNC" && i + SYNC_VALUES < args.size()) {
+            std::string values;
+            for (int v = 1; v <= SYNC_VALUES; v++) {
+                values += "," + args[i + v];
+            }
+            checkSync(slot, args[i + 1], args[i + 2]);
+            sendTo(slot == 1 ? 2 : 1, "PEER_SYNC" + values, now);
+            i += SYNC_VALUES;
+        }
+        else if (args[i] == "HEARTBEAT") {
+            // Only keeps the connection alive
+        }
+        else if (args[i] == "ROLLBACK_JOIN" && i + 1 < args.size()) {
+            joinRollback(slot, args[i + 1], now);
+            i += 1;
+        }
+        else {
+            applyKey(slot, args[i]);
+        }
+    }
+
+    if (!relay.empty()) {
+        sendTo(slot == 1 ? 2 : 1, "PEER_INPUT" + relay, now);
+    }
+}
+
+// HELLO,<version>,<capabilities>[,<token>]: a known token gets its slot back, anyone else the
+// first free paddle or a spectator seat
+void ReferenceServer::handleHello(Connection& connection, const std::vector<std::string>& args, double now) {
+    int version = PROTOCOL_VERSION;
+    int offered = 0;
+    if (args.size() < 2 || !parseInt(args[0], version) || !parseInt(args[1], offered)) {
+        std::cerr << "Malformed HELLO from connection " << connection.number << std::endl;
+        version = PROTOCOL_VERSION;
+    }
+    version = std::min(version, PROTOCOL_VERSION);
+
+    int slot = 0;
+    std::string token = args.size() > 2 ? args[2] : "";
+    auto previous = token.empty() ? tokenSlots.end() : tokenSlots.find(token);
+    bool resumed = previous != tokenSlots.end() && previous->second != 0;
+    if (resumed) {
+        // A connection still holding the token is the session's old link; it is closed
+        slot = previous->second;
+        reservedUntil[slot] = 0;
+        for (auto& stale : connections) {
+            if (stale.get() != &connection && stale->token == token) {
+                stale->hasSlot = false;
+                stale->token.clear();
+                stale->closed = true;
+            }
+        }
+    }
+    else {
+        for (int candidate = 1; candidate <= 2 && slot == 0; candidate++) {
+            if (!isSlotTaken(candidate, now)) {
+                slot = candidate;
+            }
+        }
+        token = newSessionToken();
+        tokenSlots[token] = slot;
+        if (slot != 0) {
+            players[slot] = PlayerInput();  // Acks start over rather than continuing the previous owner's
+        }
+    }
+    connection.hasSlot = true;
+    connection.slot = slot;
+    connection.token = token;
+
+    // TCP always keeps the cipher, as the Java server does; shared memory keeps what it was started with
+    bool shm = connection.socket() == NO_SOCKET;
+    int chosen = (offered & SERVER_CAPABILITIES) | (shm ? offered & CAP_SHM_TRANSPORT : 0);
+    chosen = connection.channel->hasCipher() ? chosen | CAP_CIPHER : chosen & ~CAP_CIPHER;
+    post(connection, "WELCOME," + std::to_string(version) + "," + std::to_string(slot) + "," + std::to_string(tickRate) + "," +
+                         std::to_string(chosen) + "," + token + "," + (resumed ? "1" : "0"), now);
+    std::cout << "Connection " << connection.number << (resumed ? " resumed" : " joined") << " as player " << slot
+              << " (protocol " << version << ", capabilities " << chosen << ")" << std::endl;
+
+    if (resumed) {
+        post(connection, "SCORES," + std::to_string(sim.state.score[0]) + "," + std::to_string(sim.state.score[1]), now);
+        post(connection, gameDataFor(slot, now), now);
+    }
+}
+
+// Start a rollback match once both players have asked for one, using the larger input delay
+void ReferenceServer::joinRollback(int slot, const std::string& delay, double now) {
+    int inputDelay = 0;
+    if ((slot != 1 && slot != 2) || !parseInt(delay, inputDelay)) {
+        return;
+    }
+    rollbackDelays[slot] = inputDelay;
+    if (rollbackDelays.size() == 2) {
+        inputDelay = std::max(rollbackDelays[1], rollbackDelays[2]);
+        lastRelayedFrame[1] = lastRelayedFrame[2] = -1;
+        rollbackActive = true;
+        sendTo(1, "ROLLBACK_START,1," + std::to_string(inputDelay), now);
+        sendTo(2, "ROLLBACK_START,2," + std::to_string(inputDelay), now);
+        std::cout << "Rollback match started with an input delay of " << inputDelay << std::endl;
+    }
+}
+
+// Compare both players' rolling state hashes for a tick and report any disagreement
+void ReferenceServer::checkSync(int slot, const std::string& tick, const std::string& hash) {
+    auto other = syncHashes.find(tick);
+    if (other == syncHashes.end()) {
+        if (syncHashes.size() > MAX_SYNC_HASHES) {
+            syncHashes.clear();  // A player stopped sending; don't grow forever
+        }
+        syncHashes[tick] = hash;
+        return;
+    }
+    if (other->second != hash) {
+        std::cout << "Rollback desync at tick " << tick << " (player " << slot << " hash " << hash << ", other "
+                  << other->second << ")" << std::endl;
+    }
+    syncHashes.erase(other);
+}
+
+// Forward a player's input frame to the other player, in order and without duplicates
+void ReferenceServer::relayFrame(int slot, const std::string& tickToken, const std::string& buttonsToken, std::string& relay) {
+    int frame = 0;
+    int buttons = 0;
+    if (!rollbackActive || (slot != 1 && slot != 2)) {
+        return;
+    }
+    if (!parseInt(tickToken, frame) || !parseInt(buttonsToken, buttons)) {
+        std::cerr << "Bad FRAME from player " << slot << std::endl;
+        return;
+    }
+    if (frame <= lastRelayedFrame[slot]) {
+        return;
+    }
+    lastRelayedFrame[slot] = frame;
+    relay += "," + std::to_string(frame) + "," + std::to_string(buttons);
+}
+
+// Legacy key events: held keys move the paddle until released
+void ReferenceServer::applyKey(int slot, const std::string& key) {
+    if (slot != 1 && slot != 2) {
+        return;
+    }
+    int& keys = players[slot].keys;
+    if (key == "W_DOWN") {
+        keys |= PaddleRules::UP;
+    }
+    else if (key == "S_DOWN") {
+        keys |= PaddleRules::DOWN;
+    }
+    else if (key == "W_UP") {
+        keys &= ~PaddleRules::UP;
+    }
+    else if (key == "S_UP") {
+        keys &= ~PaddleRules::DOWN;
+    }
+}
+
+// One server frame in PongApp's order: every connection gets the state as it stands, the
+// queued inputs are applied and the physics step raises its events
+void ReferenceServer::tick(double now) {
+    serverTick++;
+    stats.ticks++;
+    for (auto& connection : connections) {
+        postTick(*connection, gameDataFor(slotOf(*connection, now), now));
+    }
+    dropSilentConnections(now);
+
+    int buttons1 = applyQueuedInput(1, now);
+    int buttons2 = applyQueuedInput(2, now);
+    int events = sim.step(buttons1, buttons2);
+
+    std::string scores = "SCORES," + std::to_string(sim.state.score[0]) + "," + std::to_string(sim.state.score[1]);
+    if (events & EVENT_HIT_WALL_LEFT) {
+        broadcast(scores);
+        broadcast("HIT_WALL_LEFT");
+    }
+    if (events & EVENT_HIT_WALL_RIGHT) {
+        broadcast(scores);
+        broadcast("HIT_WALL_RIGHT");
+    }
+    if (events & EVENT_HIT_WALL_UP) {
+        broadcast("HIT_WALL_UP");
+    }
+    if (events & EVENT_HIT_WALL_DOWN) {
+        broadcast("HIT_WALL_DOWN");
+    }
+    // PongApp's bat handler broadcasts twice, and clients see the hit twice, so this does too
+    if (events & EVENT_BALL_HIT_BAT1) {
+        broadcast("BALL_HIT_BAT1");
+        broadcast("BALL_HIT_BAT1");
+    }
+    if (events & EVENT_BALL_HIT_BAT2) {
+        broadcast("BALL_HIT_BAT2");
+        broadcast("BALL_HIT_BAT2");
+    }
+
+    if (serverTick % burstTicks == 0) {
+        releaseBursts(now);
+    }
+}
+
+// Buttons a player's paddle moves with this tick: the next queued input, nothing if none came
+// in time, or the held legacy keys for clients that never sent INPUT
+int ReferenceServer::applyQueuedInput(int slot, double now) {
+    PlayerInput& player = players[slot];
+    if (!player.usesInputs) {
+        return player.keys;
+    }
+    if (player.pending.empty()) {
+        if (player.lastAppliedButtons != 0) {
+            player.starvedTicks++;  // Key held but the next input isn't here yet
+        }
+        return 0;
+    }
+
+    while (player.pending.size() > MAX_BUFFERED_INPUTS) {
+        player.lastAppliedInput = player.pending.front().seq;
+        player.pending.pop_front();
+    }
+    QueuedInput input = player.pending.front();
+    player.pending.pop_front();
+    player.lastAppliedInput = input.seq;
+    player.lastAppliedButtons = input.buttons;
+    player.inputMargin = player.starvedTicks > 0 ? -player.starvedTicks * tickMs : now - input.arrival;
+    player.starvedTicks = 0;
+    return input.buttons;
+}
+
+// GAME_DATA,p1Y,p2Y,ballX,ballY,p1X,p2X,slot,score1,score2,lastInput,ballVX,ballVY,tick,timeMs,inputMargin
+// Velocities are in px/s at the game's 60 Hz, the units clients convert back to px/tick
+std::string ReferenceServer::gameDataFor(int slot, double now) const {
+    const PongState& state = sim.state;
+    bool player = slot == 1 || slot == 2;
+    std::string data = "GAME_DATA";
+    data += "," + formatNumber(fixedToFloat(state.paddleY[0]));
+    data += "," + formatNumber(fixedToFloat(state.paddleY[1]));
+    data += "," + formatNumber(fixedToFloat(state.ballX));
+    data += "," + formatNumber(fixedToFloat(state.ballY));
+    data += "," + formatNumber(fixedToFloat(state.paddleX[0]));
+    data += "," + formatNumber(fixedToFloat(state.paddleX[1]));
+    data += "," + std::to_string(slot);
+    data += "," + std::to_string(state.score[0]);
+    data += "," + std::to_string(state.score[1]);
+    data += "," + std::to_string(player ? players[slot].lastAppliedInput : 0);
+    data += "," + formatNumber(fixedToFloat(state.ballVX) * tickRate);  // px per tick to px/s
+    data += "," + formatNumber(fixedToFloat(state.ballVY) * tickRate);
+    data += "," + std::to_string(serverTick);
+    data += "," + formatNumber(now, "%.3f");
+    data += "," + formatNumber(player ? players[slot].inputMargin : 0, "%.3f");
+    return data;
+}
+
+// Close connections that have gone quiet; their slot is then reserved like any other drop
+void ReferenceServer::dropSilentConnections(double now) {
+    for (auto& connection : connections) {
+        if (!connection->closed && now - connection->lastHeard > CLIENT_TIMEOUT_MS) {
+            std::cout << "Connection " << connection->number << " timed out" << std::endl;
+            connection->closed = true;
+        }
+    }
+}
+
+void ReferenceServer::removeClosed(double now) {
+    for (auto it = connections.begin(); it != connections.end();) {
+        Connection& connection = **it;
+        if (!connection.closed) {
+            ++it;
+            continue;
+        }
+        if (connection.socket() == NO_SOCKET) {
+            shmInUse = false;  // Its segment is unlinked with it; pollShm hosts a new one
+        }
+        disconnected(connection, now);
+        it = connections.erase(it);
+    }
+}
+
+// Keep a player's slot for a while so the same session can reconnect, and stop anything
+// that depended on the player being there
+void ReferenceServer::disconnected(Connection& connection, double now) {
+    if (!connection.hasSlot || connection.slot == 0) {
+        if (!connection.token.empty()) {
+            tokenSlots.erase(connection.token);
+        }
+        return;
+    }
+    int slot = connection.slot;
+    reservedUntil[slot] = now + RESUME_WINDOW_MS;
+    players[slot].pending.clear();
+    if (rollbackActive || rollbackDelays.count(slot)) {
+        // The rollback match cannot continue with one side missing; both clients rejoin
+        rollbackActive = false;
+        rollbackDelays.clear();
+        syncHashes.clear();
+        sendTo(slot == 1 ? 2 : 1, "ROLLBACK_STOP", now);
+    }
+    std::cout << "Player " << slot << " disconnected; slot held for " << RESUME_WINDOW_MS / 1000 << " s" << std::endl;
+}
+
+// A slot is taken while a connection holds it or its previous owner may still resume it
+bool ReferenceServer::isSlotTaken(int slot, double now) {
+    for (auto& connection : connections) {
+        if (!connection->closed && connection->hasSlot && connection->slot == slot) {
+            return true;
+        }
+    }
+    if (reservedUntil[slot] > now) {
+        return true;
+    }
+    reservedUntil[slot] = 0;
+    for (auto it = tokenSlots.begin(); it != tokenSlots.end();) {
+        it = it->second == slot ? tokenSlots.erase(it) : std::next(it);  // The old session can no longer resume
+    }
+    return false;
+}
+
+// Clients that never sent HELLO play on their connection number, as PongApp.slotOf does, until a
+// handshake client holds or may resume a paddle; from then on they are spectators
+int ReferenceServer::slotOf(const Connection& connection, double now) {
+    if (connection.hasSlot) {
+        return connection.slot;
+    }
+    return isSlotTaken(1, now) || isSlotTaken(2, now) ? 0 : connection.number;
+}
+
+std::string ReferenceServer::newSessionToken() {
+    char token[17];
+    snprintf(token, sizeof(token), "%08x%08x", (unsigned)tokenSource(), (unsigned)tokenSource());
+    return token;
+}
+
+// Replies go out as soon as the jitter allows
+void ReferenceServer::post(Connection& connection, const std::string& message, double now) {
+    double releaseAt = std::max(now + jitterDelay(), connection.lastReleaseAt);
+    connection.lastReleaseAt = releaseAt;
+    connection.outbox.push_back({ releaseAt, message });
+    connection.outboxBytes += message.length();
+}
+
+// Per-tick messages wait for the end of the burst
+void ReferenceServer::postTick(Connection& connection, const std::string& message) {
+    connection.held.push_back(message);
+}
+
+void ReferenceServer::sendTo(int slot, const std::string& message, double now) {
+    for (auto& connection : connections) {
+        if (slotOf(*connection, now) == slot) {
+            post(*connection, message, now);
+        }
+    }
+}
+
+void ReferenceServer::broadcast(const std::string& message) {
+    for (auto& connection : connections) {
+        postTick(*connection, message);
+    }
+}
+
+// A burst leaves together: one jitter delay for all of its messages
+void ReferenceServer::releaseBursts(double now) {
+    for (auto& connection : connections) {
+        if (connection->held.empty()) {
+            continue;
+        }
+        double releaseAt = std::max(now + jitterDelay(), connection->lastReleaseAt);
+        connection->lastReleaseAt = releaseAt;
+        for (std::string& message : connection->held) {
+            connection->outboxBytes += message.length();
+            connection->outbox.push_back({ releaseAt, std::move(message) });
+        }
+        connection->held.clear();
+    }
+}
+
+// Never blocks: what a connection cannot take now stays in its outbox for the next pass
+void ReferenceServer::flush(double now) {
+    for (auto& connection : connections) {
+        if (connection->closed) {
+            continue;
+        }
+        while (!connection->outbox.empty() && connection->outbox.front().releaseAt <= now) {
+            const std::string& message = connection->outbox.front().message;
+            if (!connection->channel->canSend((int)message.length())) {
+                break;  // Ring or send queue full; the rest waits for the client to catch up
+            }
+            if (!connection->channel->sendMessage(message)) {
+                connection->closed = true;
+                break;
+            }
+            stats.messages++;
+            stats.bytes += (long)message.length() + 2;
+            connection->outboxBytes -= message.length();
+            connection->outbox.pop_front();
+        }
+        connection->sendQueued = connection->channel->getTransport()->flushSendQueue();  // What is left after the sends
+        if (connection->sendQueued < 0) {
+            connection->closed = true;
+        }
+        else if (!connection->closed && connection->outboxBytes > MAX_OUTBOX_BYTES) {
+            std::cerr << "Connection " << connection->number << " is " << connection->outboxBytes
+                      << " bytes behind; closing it as a slow consumer" << std::endl;
+            connection->closed = true;
+            stats.slowConsumers++;
+        }
+    }
+}
+
+double ReferenceServer::jitterDelay() {
+    return jitterMs > 0 ? std::uniform_real_distribution<double>(0, jitterMs)(random) : 0;
+}
+
+void ReferenceServer::printReport(double elapsedMs) {
+    int playerCount = 0;
+    for (auto& connection : connections) {
+        playerCount += connection->hasSlot && connection->slot != 0 ? 1 : 0;
+    }
+    double seconds = elapsedMs / 1000;
+    std::cout << connections.size() << " connections (" << playerCount << " players), tick " << serverTick << ", score "
+              << sim.state.score[0] << "-" << sim.state.score[1] << ", " << stats.ticks / seconds << " ticks/s, "
+              << stats.messages / seconds << " msg/s, " << stats.bytes / seconds / 1024 << " KB/s, worst tick "
+              << stats.worstLateMs << " ms late, " << stats.skippedTicks << " ticks skipped, " << stats.slowConsumers
+              << " closed as slow consumers" << std::endl;
+}
+
+static std::atomic<bool> running{ true };
+
+static void onSignal(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    auto server = std::make_unique<ReferenceServer>();
+    double durationS = 0;  // 0 = until interrupted
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            server->port = (Uint16)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            server->tickRate = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--jitter") == 0 && i + 1 < argc) {
+            server->jitterMs = std::max(0.0, atof(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--burst") == 0 && i + 1 < argc) {
+            server->burstTicks = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            server->seed = (unsigned)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            durationS = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            server->reportIntervalS = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            server->shmName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cipher") == 0) {
+            server->shmCipher = true;
+        }
+    }
+
+    if (SDL_Init(0) == -1) {
+        std::cerr << "SDL_Init: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    if (SDLNet_Init() == -1) {
+        std::cerr << "SDLNet_Init: " << SDLNet_GetError() << std::endl;
+        return 2;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    int rc = 0;
+    if (server->start()) {
+        std::cout << "Reference server on port " << server->port << " at " << server->tickRate << " Hz, jitter up to "
+                  << server->jitterMs << " ms, " << server->burstTicks << " ticks per burst, seed " << server->seed
+                  << (server->shmName.empty() ? "" : ", shared memory " + server->shmName) << std::endl;
+        server->run(durationS, running);
+    }
+    else {
+        rc = 1;
+    }
+    server.reset();  // Sockets close before SDL_net shuts down
+
+    SDLNet_Quit();
+    SDL_Quit();
+    return rc;
+}
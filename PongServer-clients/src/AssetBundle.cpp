@@ -0,0 +1,147 @@
+#include "AssetBundle.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool AssetBundle::map(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    void* view = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    }
+    if (mapping) {
+        view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    }
+    if (!view) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    base = (Uint8*)view;
+    size = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+void AssetBundle::unmap() {
+    if (base) {
+        UnmapViewOfFile(base);
+        CloseHandle((HANDLE)mappingHandle);
+        CloseHandle((HANDLE)fileHandle);
+        base = nullptr;
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+        size = 0;
+    }
+}
+
+#else  // !_WIN32
+
+bool AssetBundle::map(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);  // The mapping keeps the file alive
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    base = (Uint8*)mapped;
+    size = (size_t)info.st_size;
+    return true;
+}
+
+void AssetBundle::unmap() {
+    if (base) {
+        munmap(base, size);
+        base = nullptr;
+        size = 0;
+    }
+}
+
+#endif  // _WIN32
+
+bool AssetBundle::open(const std::string& path) {
+    close();
+    if (!map(path)) {
+        return false;  // No bundle is not an error: the loose files are used instead
+    }
+
+    // Check everything up front, so entries can be used later without bounds checks
+    bool valid = size >= sizeof(BundleHeader);
+    const BundleHeader& header = getHeader();
+    if (valid && (header.magic != BUNDLE_MAGIC || header.version != BUNDLE_VERSION)) {
+        std::cerr << "Asset bundle " << path << " has an unknown format; repack it" << std::endl;
+        valid = false;
+    }
+    if (valid && (Uint64)header.entryCount * sizeof(BundleEntry) > size - sizeof(BundleHeader)) {
+        valid = false;
+    }
+    const BundleEntry* entries = (const BundleEntry*)(base + sizeof(BundleHeader));
+    for (Uint32 i = 0; valid && i < header.entryCount; i++) {
+        const BundleEntry& entry = entries[i];
+        if (entry.offset > size || entry.size > size - entry.offset || entry.name[BUNDLE_NAME_LENGTH - 1] != '\0') {
+            valid = false;
+        }
+        else if (entry.type == BUNDLE_IMAGE &&
+                 ((Uint64)entry.width * 4 > entry.pitch || (Uint64)entry.pitch * entry.height > entry.size)) {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        std::cerr << "Asset bundle " << path << " is damaged; using the loose files" << std::endl;
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+void AssetBundle::close() {
+    unmap();
+}
+
+const BundleEntry* AssetBundle::find(const std::string& name, BundleEntryType type) const {
+    if (!base) {
+        return nullptr;
+    }
+    const BundleEntry* entries = (const BundleEntry*)(base + sizeof(BundleHeader));
+    for (Uint32 i = 0; i < getHeader().entryCount; i++) {
+        if (entries[i].type == (Uint32)type && name == entries[i].name) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+SDL_Surface* AssetBundle::createSurface(const BundleEntry& entry) const {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(getData(entry), (int)entry.width, (int)entry.height, 32,
+                                                              (int)entry.pitch, entry.pixelFormat);
+    if (!surface) {
+        std::cerr << "Failed to wrap bundled image " << entry.name << ": " << SDL_GetError() << std::endl;
+    }
+    return surface;
+}
@@ -0,0 +1,76 @@
+#ifndef __ASSET_BUNDLE_H__
+#define __ASSET_BUNDLE_H__
+
+#include <string>
+#include "SDL.h"
+
+// Bundle file layout, written by tools/AssetPacker and read in place by AssetBundle.
+// A BundleHeader, then header.entryCount BundleEntry records, then the data of each entry at
+// its offset (aligned to BUNDLE_ALIGNMENT). Numbers are in the byte order of the machine that
+// packed it; a bundle from a machine of the other endianness is rejected by the magic check.
+//   BUNDLE_IMAGE: width * height pixels, pitch bytes per row, in pixelFormat (the atlas format)
+//   BUNDLE_SOUND: PCM frames in the format given by the header's audio fields
+//   BUNDLE_FONT:  the font file as it is on disk
+static const Uint32 BUNDLE_MAGIC = 0x31424150;  // "PAB1"
+static const Uint32 BUNDLE_VERSION = 1;
+static const Uint32 BUNDLE_ALIGNMENT = 64;
+static const int BUNDLE_NAME_LENGTH = 32;
+
+enum BundleEntryType {
+    BUNDLE_IMAGE = 1,
+    BUNDLE_SOUND = 2,
+    BUNDLE_FONT = 3
+};
+
+struct BundleHeader {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 entryCount;
+    Uint32 audioFrequency;  // Sample rate of every sound (Hz)
+    Uint16 audioFormat;     // SDL AudioFormat of every sound
+    Uint16 audioChannels;
+    Uint32 reserved;
+};
+
+struct BundleEntry {
+    char name[BUNDLE_NAME_LENGTH];  // NUL-terminated: sprite name, or the source file name
+    Uint32 type;                    // BundleEntryType
+    Uint32 width;                   // Images only
+    Uint32 height;
+    Uint32 pitch;
+    Uint32 pixelFormat;             // SDL_PixelFormatEnum
+    Uint32 reserved;
+    Uint64 offset;                  // From the start of the file
+    Uint64 size;                    // Bytes
+};
+
+// AssetBundle: a bundle file mapped into memory. Entries are used where they lie: surfaces
+// and sound chunks made from them point into the mapping, so it must stay open while they
+// are alive. The mapping is private copy-on-write, so nothing written through it reaches the file.
+class AssetBundle {
+private:
+    Uint8* base = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    bool map(const std::string& path);
+    void unmap();
+
+public:
+    ~AssetBundle() { close(); }
+
+    bool open(const std::string& path);  // Map and validate; false (and nothing mapped) on failure
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    const BundleHeader& getHeader() const { return *(const BundleHeader*)base; }
+    const BundleEntry* find(const std::string& name, BundleEntryType type) const;  // nullptr if absent
+    Uint8* getData(const BundleEntry& entry) const { return base + entry.offset; }
+
+    SDL_Surface* createSurface(const BundleEntry& entry) const;  // Surface over the mapped pixels (no copy)
+};
+
+#endif  // __ASSET_BUNDLE_H__
@@ -0,0 +1,222 @@
+#include "AssetLoader.h"
+#include "SDL_image.h"
+#include "Timing.h"
+#include <iostream>
+
+// The scene images and the atlas names they are drawn by
+static const char* IMAGE_FILES[][2] = {
+    { "bg", "bg.png" },
+    { "ball", "ball.png" },
+    { "paddle2", "paddle2.png" },
+    { "paddle", "paddle.png" },
+};
+
+static const char* FONT_FILE = "Supercharge-JRgPo.otf";
+
+void AssetLoader::start(const std::string& assetRoot, StartupTimeline* startupTimeline) {
+    if (isStarted()) {
+        return;
+    }
+    root = assetRoot.empty() ? findRoot() : assetRoot;
+    timeline = startupTimeline;
+
+    double mapStart = nowMs();
+    if (!bundleName.empty() && bundle.open(root + bundleName) && timeline) {
+        timeline->mark("bundle mapped", nowMs() - mapStart);
+    }
+
+    // IMG_Load initialises codecs on first use, which is not thread-safe; do it once up front
+    IMG_Init(IMG_INIT_PNG);
+
+    // Sized before any worker starts, so the elements they write to never move
+    images.resize(sizeof(IMAGE_FILES) / sizeof(IMAGE_FILES[0]));
+    imageJobs.resize(images.size());
+    for (size_t i = 0; i < images.size(); i++) {
+        images[i].name = IMAGE_FILES[i][0];
+        images[i].path = root + IMAGE_FILES[i][1];
+        imageJobs[i] = { this, &images[i] };
+    }
+
+    // Bundled images are already in the atlas format; only missing ones are decoded
+    for (ImageJob& job : imageJobs) {
+        const BundleEntry* entry = bundle.find(job.image->name, BUNDLE_IMAGE);
+        if (entry) {
+            job.image->surface = bundle.createSurface(*entry);
+        }
+        if (!job.image->surface) {
+            startWorker(decodeImage, "ImageDecode", &job);
+        }
+    }
+    startWorker(loadAudio, "AudioLoad", this);
+    startWorker(loadFont, "FontLoad", this);
+}
+
+void AssetLoader::startWorker(SDL_ThreadFunction work, const char* name, void* data) {
+    SDL_Thread* worker = SDL_CreateThread(work, name, data);
+    if (!worker) {
+        work(data);  // No thread to spare: load it now instead
+        return;
+    }
+    workers.push_back(worker);
+}
+
+void AssetLoader::wait() {
+    for (SDL_Thread* worker : workers) {
+        SDL_WaitThread(worker, nullptr);
+    }
+    workers.clear();
+    imageJobs.clear();
+}
+
+int AssetLoader::decodeImage(void* jobPtr) {
+    ImageJob* job = (ImageJob*)jobPtr;
+    Image* image = job->image;
+    double start = nowMs();
+    image->surface = IMG_Load(image->path.c_str());
+    image->decodeMs = nowMs() - start;
+    if (!image->surface) {
+        std::cerr << "Failed to load image: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+    if (job->loader->timeline) {
+        job->loader->timeline->mark("decoded " + image->name, image->decodeMs);
+    }
+    return 0;
+}
+
+int AssetLoader::loadAudio(void* self) {
+    AssetLoader* loader = (AssetLoader*)self;
+    double start = nowMs();
+
+    // Only WAV files are played, which SDL_mixer decodes without optional codecs, so Mix_Init
+    // has nothing to load. The device's native rate is accepted rather than resampled to, which
+    // would add a conversion stage and its buffering. Without an audio device the game still
+    // runs, silently
+    if (Mix_OpenAudioDevice(loader->audioFrequency, MIX_DEFAULT_FORMAT, 2, loader->audioChunkSize, nullptr,
+                            SDL_AUDIO_ALLOW_FREQUENCY_CHANGE) < 0) {
+        std::cerr << "SDL_mixer could not open audio! SDL_mixer Error: " << Mix_GetError() << std::endl;
+        return 1;
+    }
+    loader->audioOpen = true;
+    double opened = nowMs();
+    if (loader->timeline) {
+        loader->timeline->mark("audio device opened", opened - start);
+    }
+
+    loader->ballHitSound = loader->loadSound("ball_hit.wav");
+    if (!loader->ballHitSound) {
+        std::cerr << "Failed to load ball hit sound: " << Mix_GetError() << std::endl;
+    }
+    else {
+        Mix_VolumeChunk(loader->ballHitSound, MIX_MAX_VOLUME);  // Set to maximum volume
+    }
+
+    loader->scoreSound = loader->loadSound("score.wav");
+    if (!loader->scoreSound) {
+        std::cerr << "Failed to load score sound: " << Mix_GetError() << std::endl;
+    }
+    if (loader->timeline) {
+        loader->timeline->mark("sounds loaded", nowMs() - opened);
+    }
+    return 0;
+}
+
+Mix_Chunk* AssetLoader::loadSound(const std::string& file) {
+    const BundleEntry* entry = bundle.find(file, BUNDLE_SOUND);
+    if (entry) {
+        return loadBundledSound(*entry);
+    }
+    return Mix_LoadWAV((root + file).c_str());
+}
+
+Mix_Chunk* AssetLoader::loadBundledSound(const BundleEntry& entry) {
+    int frequency, channels;
+    Uint16 format;
+    if (Mix_QuerySpec(&frequency, &format, &channels) == 0) {
+        return nullptr;
+    }
+
+    // Packed for this output format: play straight from the mapping
+    const BundleHeader& header = bundle.getHeader();
+    if ((int)header.audioFrequency == frequency && header.audioFormat == format && (int)header.audioChannels == channels) {
+        return Mix_QuickLoad_RAW(bundle.getData(entry), (Uint32)entry.size);
+    }
+
+    // The device came up in another format: convert a copy once, as Mix_LoadWAV would
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, header.audioFormat, (Uint8)header.audioChannels, (int)header.audioFrequency,
+                          format, (Uint8)channels, frequency) < 0) {
+        return nullptr;
+    }
+    cvt.len = (int)entry.size;
+    cvt.len_cvt = cvt.len;  // What is played when no conversion turns out to be needed
+    cvt.buf = (Uint8*)SDL_malloc((size_t)cvt.len * cvt.len_mult);
+    if (!cvt.buf) {
+        return nullptr;
+    }
+    SDL_memcpy(cvt.buf, bundle.getData(entry), entry.size);
+    if (cvt.needed && SDL_ConvertAudio(&cvt) < 0) {
+        SDL_free(cvt.buf);
+        return nullptr;
+    }
+    Mix_Chunk* chunk = Mix_QuickLoad_RAW(cvt.buf, (Uint32)cvt.len_cvt);
+    if (!chunk) {
+        SDL_free(cvt.buf);
+        return nullptr;
+    }
+    chunk->allocated = 1;  // Mix_FreeChunk frees the converted copy
+    return chunk;
+}
+
+int AssetLoader::loadFont(void* self) {
+    AssetLoader* loader = (AssetLoader*)self;
+    double start = nowMs();
+    if (TTF_Init() == -1) {
+        std::cerr << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << std::endl;
+        return 1;
+    }
+    const BundleEntry* entry = loader->bundle.find(FONT_FILE, BUNDLE_FONT);
+    if (entry) {
+        SDL_RWops* data = SDL_RWFromConstMem(loader->bundle.getData(*entry), (int)entry->size);
+        loader->font = TTF_OpenFontRW(data, 1, loader->fontSize);  // Glyphs are read from the mapping on demand
+    }
+    else {
+        loader->font = TTF_OpenFont((loader->root + FONT_FILE).c_str(), loader->fontSize);
+    }
+    if (!loader->font) {
+        std::cerr << "Failed to load font! TTF Error: " << TTF_GetError() << std::endl;
+        return 1;
+    }
+    if (loader->timeline) {
+        loader->timeline->mark("font loaded", nowMs() - start);
+    }
+    return 0;
+}
+
+std::string AssetLoader::findRoot() {
+    std::vector<std::string> candidates;
+    const char* env = SDL_getenv("PONG_ASSETS");
+    if (env && *env) {
+        std::string dir = env;
+        if (dir.back() != '/' && dir.back() != '\\') {
+            dir += '/';
+        }
+        candidates.push_back(dir);
+    }
+    char* base = SDL_GetBasePath();  // Directory of the executable, ending in a separator
+    if (base) {
+        candidates.push_back(std::string(base) + "assets/");
+        candidates.push_back(std::string(base) + "../assets/");
+        SDL_free(base);
+    }
+    candidates.push_back("assets/");
+
+    for (const std::string& dir : candidates) {
+        SDL_RWops* probe = SDL_RWFromFile((dir + IMAGE_FILES[0][1]).c_str(), "rb");
+        if (probe) {
+            SDL_RWclose(probe);
+            return dir;
+        }
+    }
+    return candidates.back();
+}
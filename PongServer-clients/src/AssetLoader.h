@@ -0,0 +1,77 @@
+#ifndef __ASSET_LOADER_H__
+#define __ASSET_LOADER_H__
+
+#include <string>
+#include <vector>
+#include "SDL.h"
+#include "SDL_mixer.h"
+#include "SDL_ttf.h"
+#include "AssetBundle.h"
+#include "StartupTimeline.h"
+
+// AssetLoader: reads and decodes the game's assets on worker threads, so startup does not
+// wait for them one after another. Each image is decoded on its own worker; the audio device
+// is opened and the sounds loaded on another, and the font on a third. Nothing here needs a
+// renderer: the decoded surfaces are handed over after wait() and only their upload to
+// textures happens on the render thread.
+// If the root holds a bundle (tools/AssetPacker), it is mapped instead and nothing is
+// decoded: images are surfaces over the mapped pixels and sounds play from the mapped PCM.
+// The loader keeps the bundle mapped, so it must outlive the sounds and the font.
+class AssetLoader {
+public:
+    struct Image {
+        std::string name;               // Sprite name in the atlas
+        std::string path;
+        SDL_Surface* surface = nullptr; // Decoded pixels, owned by whoever takes them
+        double decodeMs = 0;
+    };
+
+private:
+    struct ImageJob {
+        AssetLoader* loader;
+        Image* image;
+    };
+
+    std::vector<Image> images;
+    std::vector<ImageJob> imageJobs;  // One per image, alive until wait()
+    std::vector<SDL_Thread*> workers;
+    std::string root;
+    StartupTimeline* timeline = nullptr;
+    AssetBundle bundle;
+
+    Mix_Chunk* loadSound(const std::string& file);  // From the bundle if it has it, else decoded from the file
+    Mix_Chunk* loadBundledSound(const BundleEntry& entry);
+
+    void startWorker(SDL_ThreadFunction work, const char* name, void* data);
+    static int decodeImage(void* job);
+    static int loadAudio(void* self);
+    static int loadFont(void* self);
+
+public:
+    int audioFrequency = 48000;  // Requested mixer rate (Hz); a device running at another rate keeps its own
+    int audioChunkSize = 512;    // Mixer buffer (samples): 256-512 keeps a sound's start within ~10 ms
+    int fontSize = 22;
+    std::string bundleName = "assets.bundle";  // Bundle looked for under the root (empty = loose files only)
+
+    // Results, valid after wait()
+    bool audioOpen = false;
+    Mix_Chunk* ballHitSound = nullptr;
+    Mix_Chunk* scoreSound = nullptr;
+    TTF_Font* font = nullptr;
+
+    ~AssetLoader() { wait(); }
+
+    // Start decoding everything under root (ending in a separator); timeline, if given, gets
+    // a mark as each asset finishes
+    void start(const std::string& root, StartupTimeline* timeline = nullptr);
+    void wait();  // Block until every worker has finished
+    bool isStarted() const { return !root.empty(); }
+    bool isBundled() const { return bundle.isOpen(); }
+    std::vector<Image>& getImages() { return images; }  // Decoded images; take the surfaces after wait()
+
+    // Where the assets are when no root is given: $PONG_ASSETS, then an assets directory next
+    // to the executable or one level up, then ./assets/
+    static std::string findRoot();
+};
+
+#endif  // __ASSET_LOADER_H__
@@ -0,0 +1,157 @@
+#include "BotController.h"
+#include "InputScript.h"
+#include "PongSim.h"
+#include <cmath>
+
+// Longest the ball is run forward looking for the paddle (ticks)
+static const int MAX_LOOKAHEAD_TICKS = 4 * PongSim::TICK_RATE;
+
+// Our paddle in the game state
+static float paddleX(const GameData& data, int player) {
+    return player == 1 ? data.player1X : data.player2X;
+}
+
+static float paddleCentre(const GameData& data, int player) {
+    return (player == 1 ? data.player1Y : data.player2Y) + PongSim::PADDLE_HEIGHT / 2.0f;
+}
+
+static float ballCentre(const GameData& data) {
+    return data.ballY + PongSim::BALL_SIZE / 2.0f;
+}
+
+// Hold the key that moves the paddle centre towards `target`
+static int steerTo(float centre, float target, float deadZone) {
+    if (target < centre - deadZone) {
+        return PaddleRules::UP;
+    }
+    if (target > centre + deadZone) {
+        return PaddleRules::DOWN;
+    }
+    return 0;
+}
+
+// Is the ball heading for the paddle at x, from whichever side it is on?
+static bool ballApproaching(const GameData& data, float x) {
+    if (data.ballX + PongSim::BALL_SIZE <= x) {
+        return data.ballVX > 0;
+    }
+    if (data.ballX >= x + PongSim::PADDLE_WIDTH) {
+        return data.ballVX < 0;
+    }
+    return false;
+}
+
+int PerfectBot::decide(const GameData& data, int player, double) {
+    float x = paddleX(data, player);
+    float target = ballCentre(data);
+
+    // Step the ball with the game's rules, paddles out of the way, until it reaches ours
+    if (data.hasBallVelocity && ballApproaching(data, x)) {
+        PongSim sim;
+        sim.state.ballX = fixedFromDouble(data.ballX);
+        sim.state.ballY = fixedFromDouble(data.ballY);
+        sim.state.ballVX = fixedFromDouble(data.ballVX / PongSim::TICK_RATE);
+        sim.state.ballVY = fixedFromDouble(data.ballVY / PongSim::TICK_RATE);
+        sim.state.paddleY[0] = sim.state.paddleY[1] = fixedFromInt(-10 * PongSim::HEIGHT);
+        Fixed left = fixedFromDouble(x);
+        Fixed right = fixedFromDouble(x + PongSim::PADDLE_WIDTH);
+        for (int i = 0; i < MAX_LOOKAHEAD_TICKS; i++) {
+            int events = sim.stepBall();
+            if (sim.state.ballX < right && sim.state.ballX + fixedFromInt(PongSim::BALL_SIZE) > left) {
+                target = fixedToFloat(sim.state.ballY) + PongSim::BALL_SIZE / 2.0f;
+                break;
+            }
+            if (events & (EVENT_HIT_WALL_LEFT | EVENT_HIT_WALL_RIGHT)) {
+                break;  // Goes past us into a wall; keep following it
+            }
+        }
+    }
+    return steerTo(paddleCentre(data, player), target, deadZone);
+}
+
+// Where a ball seen at (x, y) moving (vx, vy) crosses targetX, bouncing off the top and bottom walls
+static float guessCrossing(float x, float y, float vx, float vy, float targetX) {
+    if (vx == 0) {
+        return y + PongSim::BALL_SIZE / 2.0f;
+    }
+    float span = (float)(PongSim::HEIGHT - PongSim::BALL_SIZE);
+    float unfolded = std::fmod(y + vy * (targetX - x) / vx, 2 * span);
+    if (unfolded < 0) {
+        unfolded += 2 * span;
+    }
+    return (unfolded > span ? 2 * span - unfolded : unfolded) + PongSim::BALL_SIZE / 2.0f;
+}
+
+int HumanBot::decide(const GameData& data, int player, double now) {
+    seen.emplace_back(now, data);
+    if (now - lastChange < minHoldMs) {
+        return buttons;
+    }
+
+    // The ball as it was one reaction time ago; our own paddle as it is now
+    while (seen.size() > 1 && seen[1].first <= now - currentReactionMs) {
+        seen.pop_front();
+    }
+    if (seen.front().first > now - currentReactionMs) {
+        return buttons;  // Not playing long enough to have seen anything
+    }
+    const GameData& view = seen.front().second;
+
+    float x = paddleX(data, player);
+    bool coming = view.hasBallVelocity && ballApproaching(view, x);
+    if (coming && !approaching) {
+        // A fresh guess, and a fresh reaction time, for each approach
+        aimError = std::normal_distribution<float>(0, aimErrorPx)(random);
+        currentReactionMs = reactionMs + std::uniform_real_distribution<double>(-reactionSpreadMs, reactionSpreadMs)(random);
+    }
+    approaching = coming;
+
+    float target = PongSim::HEIGHT / 2.0f;  // Back to the middle while the ball goes away
+    if (coming) {
+        float faceX = view.ballX < x ? x - PongSim::BALL_SIZE : x + PongSim::PADDLE_WIDTH;
+        target = guessCrossing(view.ballX, view.ballY, view.ballVX, view.ballVY, faceX) + aimError;
+    }
+    else if (!view.hasBallVelocity) {
+        target = ballCentre(view);
+    }
+
+    int wanted = steerTo(paddleCentre(data, player), target, deadZone);
+    if (wanted != buttons) {
+        buttons = wanted;
+        lastChange = now;
+    }
+    return buttons;
+}
+
+int ToggleBot::decide(const GameData&, int, double now) {
+    return (long long)(now / toggleMs) % 2 == 0 ? PaddleRules::UP : PaddleRules::DOWN;
+}
+
+std::unique_ptr<BotBehaviour> BotController::create(const std::string& name, unsigned seed) {
+    if (name == "perfect") {
+        return std::make_unique<PerfectBot>();
+    }
+    if (name == "human") {
+        return std::make_unique<HumanBot>(seed);
+    }
+    if (name == "idle") {
+        return std::make_unique<IdleBot>();
+    }
+    if (name == "toggle") {
+        return std::make_unique<ToggleBot>();
+    }
+    return nullptr;
+}
+
+void BotController::update(GameSession& game, double now) {
+    if (!behaviour) {
+        return;
+    }
+    GameData data = game.getGameData();
+    int player = data.playerID;
+    if ((player != 1 && player != 2) || game.getSnapshotsReceived() == 0) {
+        pressButtons(game, held, 0);  // A spectator, or nothing known about the game yet
+        return;
+    }
+    pressButtons(game, held, behaviour->decide(data, player, now));
+}
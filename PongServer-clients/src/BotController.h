@@ -0,0 +1,92 @@
+#ifndef __BOT_CONTROLLER_H__
+#define __BOT_CONTROLLER_H__
+
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include "GameSession.h"
+
+// BotBehaviour: decides which keys a bot holds from the game state it sees.
+// `player` is the bot's slot (1 = left paddle, 2 = right); `now` is nowMs()
+class BotBehaviour {
+public:
+    virtual ~BotBehaviour() {}
+
+    virtual int decide(const GameData& data, int player, double now) = 0;  // PaddleRules::Buttons to hold
+    virtual const char* getName() const = 0;
+};
+
+// PerfectBot: runs the ball forward with the game's rules to where it will reach our paddle
+// and waits there; follows the ball while it is behind the paddle
+class PerfectBot : public BotBehaviour {
+public:
+    float deadZone = 8;  // Paddle centre within this of the target counts as there (px)
+
+    int decide(const GameData& data, int player, double now) override;
+    const char* getName() const override { return "perfect"; }
+};
+
+// HumanBot: plays like a person. It sees the ball reactionMs late, guesses its path by eye
+// (wall bounces included, off by a random aim error drawn each time the ball turns towards
+// it), drifts back to the middle while the ball goes away, and holds or rests each key for
+// at least minHoldMs
+class HumanBot : public BotBehaviour {
+private:
+    std::mt19937 random;
+    std::deque<std::pair<double, GameData>> seen;  // Recent states and when they were seen
+    float aimError = 0;           // Current guess's error (px)
+    bool approaching = false;     // The ball was coming our way in the last state acted on
+    int buttons = 0;              // Held now
+    double lastChange = -1e9;     // When the held keys last changed
+    double currentReactionMs = 220;  // Reaction time for the current approach
+
+public:
+    double reactionMs = 220;      // Delay between the ball moving and the bot seeing it
+    double reactionSpreadMs = 60; // Reaction time varies by up to this either way, per approach
+    double minHoldMs = 80;        // Quickest a key is pressed and let go again
+    float aimErrorPx = 25;        // Standard deviation of the aim error
+    float deadZone = 15;          // Close enough to the target to let go (px)
+
+    explicit HumanBot(unsigned seed) : random(seed) {}
+
+    int decide(const GameData& data, int player, double now) override;
+    const char* getName() const override { return "human"; }
+};
+
+// IdleBot: joins and never presses anything
+class IdleBot : public BotBehaviour {
+public:
+    int decide(const GameData&, int, double) override { return 0; }
+    const char* getName() const override { return "idle"; }
+};
+
+// ToggleBot: alternates W and S every toggleMs, to stress input handling
+class ToggleBot : public BotBehaviour {
+public:
+    double toggleMs = 50;  // Time each key is held
+
+    int decide(const GameData& data, int player, double now) override;
+    const char* getName() const override { return "toggle"; }
+};
+
+// BotController: drives a session's paddle with a behaviour. update() reads the session's
+// GameData and presses or releases W and S through GameSession::input(), like the keyboard,
+// so it works in the game and in the headless client alike. Call it once per frame before update()
+class BotController {
+private:
+    std::unique_ptr<BotBehaviour> behaviour;
+    int held = 0;  // Buttons held now
+
+public:
+    // "perfect", "human", "idle" or "toggle"; nullptr for anything else
+    static std::unique_ptr<BotBehaviour> create(const std::string& name, unsigned seed);
+
+    void setBehaviour(std::unique_ptr<BotBehaviour> newBehaviour) { behaviour = std::move(newBehaviour); }
+    bool isActive() const { return behaviour != nullptr; }
+    const char* getName() const { return behaviour ? behaviour->getName() : "none"; }
+
+    void update(GameSession& game, double now);
+};
+
+#endif  // __BOT_CONTROLLER_H__
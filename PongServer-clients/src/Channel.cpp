@@ -0,0 +1,191 @@
+#include "Channel.h"
+#include <cstring>
+#include <iostream>
+
+static const int FRAME_HEADER = 2;  // Bytes in the length prefix
+
+Channel::Channel(Transport* transport, bool framed, const char* cipherKey)
+    : transport(transport), framed(framed), cipherKey(cipherKey ? cipherKey : "") {
+    receiveBuffer.resize(FRAME_HEADER + MAX_MESSAGE_LENGTH + 1);
+}
+
+Channel::~Channel() {
+    if (holdingMessage) {
+        transport->releaseMessage();
+    }
+    transport->close();
+    delete transport;
+}
+
+// XOR each byte with the key; the key position restarts for every message
+void Channel::applyCipher(char* data, int length) {
+    size_t keyLength = cipherKey.length();
+    if (keyLength == 0) {
+        return;
+    }
+    for (int i = 0; i < length; i++) {
+        data[i] ^= cipherKey[i % keyLength];
+    }
+}
+
+int Channel::receiveMessage(char*& message) {
+    for (;;) {
+        int length = tryReceiveMessage(message);
+        if (length != WOULD_BLOCK) {
+            return length;
+        }
+        if (transport->waitReadable(1000) < 0) {
+            return -1;
+        }
+    }
+}
+
+int Channel::tryReceiveMessage(char*& message) {
+    if (holdingMessage) {
+        transport->releaseMessage();
+        holdingMessage = false;
+    }
+
+    // Message-oriented transport without framing: decode the message in place
+    if (!framed && transport->isMessageOriented()) {
+        int length = transport->acquireMessage(message, 0);
+        if (length == Transport::TIMED_OUT) {
+            return WOULD_BLOCK;
+        }
+        if (length < 0) {
+            return -1;
+        }
+        holdingMessage = true;
+        applyCipher(message, length);
+        return length;
+    }
+
+    // Stream without framing: every recv is treated as one message
+    if (!framed) {
+        int ready = transport->waitReadable(0);
+        if (ready == 0) {
+            return WOULD_BLOCK;
+        }
+        int received = ready > 0 ? transport->recv(receiveBuffer.data(), MAX_MESSAGE_LENGTH) : -1;
+        if (received <= 0) {
+            return -1;
+        }
+        receiveBuffer[received] = '\0';
+        message = receiveBuffer.data();
+        applyCipher(message, received);
+        return received;
+    }
+
+    // Framed stream: reassemble length-prefixed messages, reading at most once per call
+    for (int reads = 0;; reads++) {
+        int available = bufferEnd - bufferStart;
+        if (available >= FRAME_HEADER) {
+            unsigned char* header = reinterpret_cast<unsigned char*>(&receiveBuffer[bufferStart]);
+            int length = (header[0] << 8) | header[1];
+            if (available >= FRAME_HEADER + length) {
+                message = &receiveBuffer[bufferStart + FRAME_HEADER];
+                bufferStart += FRAME_HEADER + length;
+                applyCipher(message, length);
+                return length;
+            }
+        }
+        if (reads > 0) {
+            return WOULD_BLOCK;
+        }
+
+        int ready = transport->waitReadable(0);
+        if (ready == 0) {
+            return WOULD_BLOCK;
+        }
+
+        // Move the partial frame to the front so a full frame always fits
+        if (bufferStart > 0) {
+            memmove(receiveBuffer.data(), &receiveBuffer[bufferStart], available);
+            bufferStart = 0;
+            bufferEnd = available;
+        }
+
+        int received = ready > 0 ? transport->recv(&receiveBuffer[bufferEnd], (int)receiveBuffer.size() - bufferEnd) : -1;
+        if (received <= 0) {
+            return -1;
+        }
+        bufferEnd += received;
+    }
+}
+
+bool Channel::hasBufferedMessage() const {
+    if (!framed) {
+        return false;
+    }
+    int available = bufferEnd - bufferStart;
+    if (available < FRAME_HEADER) {
+        return false;
+    }
+    const unsigned char* header = reinterpret_cast<const unsigned char*>(&receiveBuffer[bufferStart]);
+    return available >= FRAME_HEADER + ((header[0] << 8) | header[1]);
+}
+
+bool Channel::canSend(int length) const {
+    if (!framed && transport->isMessageOriented()) {
+        return transport->canSend(length);
+    }
+    return transport->canSend((framed ? FRAME_HEADER : 0) + length);
+}
+
+bool Channel::sendMessage(const char* message, int length) {
+    if (length > MAX_MESSAGE_LENGTH) {
+        std::cerr << "Message of " << length << " bytes exceeds the channel limit" << std::endl;
+        return false;
+    }
+
+    // Message-oriented transport without framing: encrypt straight into the transport's buffer
+    if (!framed && transport->isMessageOriented()) {
+        char* slot = transport->acquireSend(length);
+        if (!slot) {
+            return false;
+        }
+        memcpy(slot, message, length);
+        applyCipher(slot, length);
+        return transport->commitSend(length);
+    }
+
+    int header = framed ? FRAME_HEADER : 0;
+    sendBuffer.resize(header + length);
+    if (framed) {
+        sendBuffer[0] = (char)((length >> 8) & 0xFF);
+        sendBuffer[1] = (char)(length & 0xFF);
+    }
+    memcpy(&sendBuffer[header], message, length);
+    applyCipher(&sendBuffer[header], length);
+
+    return transport->send(sendBuffer.data(), (int)sendBuffer.size()) >= 0;
+}
+
+// Close the transport; a thread blocked in receiveMessage wakes up with -1
+void Channel::close() {
+    transport->close();
+}
+
+void splitMessage(const char* message, int length, std::string& cmd, std::vector<std::string>& args) {
+    cmd.clear();
+    args.clear();
+
+    int start = 0;
+    bool first = true;
+    for (int i = 0; i <= length; i++) {
+        if (i == length || message[i] == ',') {
+            if (first) {
+                cmd.assign(message + start, i - start);
+                first = false;
+            }
+            else if (i > start) {
+                args.push_back(std::string(message + start, i - start));  // strtok skipped empty fields too
+            }
+            start = i + 1;
+        }
+    }
+}
+
+void Channel::setCipherKey(const char* key) {
+    cipherKey = key ? key : "";
+}
@@ -0,0 +1,51 @@
+#ifndef __CHANNEL_H__
+#define __CHANNEL_H__
+
+#include "Transport.h"
+#include <string>
+#include <vector>
+
+// Channel: turns a transport into a sequence of messages.
+// Two optional stages sit on top of the transport:
+//  - framing: a 16-bit big-endian length prefix, needed to split a TCP byte stream
+//  - cipher: the XOR cipher shared with the server, applied per message
+// On a message-oriented transport with framing off, received messages are parsed
+// straight out of the transport's buffer without being copied.
+class Channel {
+private:
+    Transport* transport;  // Owned by the channel
+    bool framed;           // Length-prefix framing stage enabled
+    std::string cipherKey; // XOR key, empty when the cipher stage is disabled
+
+    std::vector<char> receiveBuffer;  // Stream reassembly buffer (unused for in-place reads)
+    int bufferStart = 0;  // First unread byte in receiveBuffer
+    int bufferEnd = 0;    // One past the last received byte in receiveBuffer
+    bool holdingMessage = false;  // A message acquired in place must be released before the next read
+    std::vector<char> sendBuffer;  // Scratch space for framing and encrypting outgoing messages
+
+    void applyCipher(char* data, int length);
+
+public:
+    static const int MAX_MESSAGE_LENGTH = 65535;  // Limit of the 16-bit length prefix
+    static const int WOULD_BLOCK = Transport::TIMED_OUT;  // tryReceiveMessage found no complete message
+
+    Channel(Transport* transport, bool framed, const char* cipherKey);
+    ~Channel();
+
+    int receiveMessage(char*& message);  // Blocks; returns message length, or -1 when the connection closed
+    int tryReceiveMessage(char*& message);  // Never blocks; returns message length, WOULD_BLOCK or -1
+    bool hasBufferedMessage() const;  // True if a complete message is already buffered
+    bool canSend(int length) const;  // True if sendMessage would not block
+    bool sendMessage(const char* message, int length);  // Returns false if the connection failed
+    bool sendMessage(const std::string& message) { return sendMessage(message.data(), (int)message.length()); }
+    void close();  // Same threading rules as Transport::close
+    void setCipherKey(const char* key);  // Change or (with nullptr) disable the cipher stage for later messages
+
+    Transport* getTransport() const { return transport; }
+    bool hasCipher() const { return !cipherKey.empty(); }
+};
+
+// Split a "CMD,arg1,arg2,..." message into its command and arguments
+void splitMessage(const char* message, int length, std::string& cmd, std::vector<std::string>& args);
+
+#endif  // __CHANNEL_H__
@@ -0,0 +1,62 @@
+#include "ClockSync.h"
+
+static const double RTT_GAIN = 1.0 / 8;  // Smoothing of the reported RTT (TCP SRTT style)
+
+bool ClockSync::pingDue(double localNow) {
+    double interval = samples < fastPings ? fastPingIntervalMs : pingIntervalMs;
+    if (localNow - lastPing < interval) {
+        return false;
+    }
+    lastPing = localNow;
+    return true;
+}
+
+void ClockSync::addSample(double sentLocalMs, double serverMs, double receivedLocalMs) {
+    double rtt = receivedLocalMs - sentLocalMs;
+    if (rtt < 0) {
+        return;
+    }
+
+    Sample sample;
+    sample.rtt = rtt;
+    sample.offset = serverMs - (sentLocalMs + receivedLocalMs) / 2;
+    window.push_back(sample);
+    if ((int)window.size() > windowSize) {
+        window.pop_front();
+    }
+
+    // Trust the most symmetric (fastest) recent exchange
+    const Sample* best = &window.front();
+    for (const Sample& candidate : window) {
+        if (candidate.rtt < best->rtt) {
+            best = &candidate;
+        }
+    }
+    minRtt = best->rtt;
+
+    if (samples == 0) {
+        offset = best->offset;
+        smoothedRtt = rtt;
+    }
+    else {
+        offset += (best->offset - offset) * offsetGain;
+        smoothedRtt += (rtt - smoothedRtt) * RTT_GAIN;
+    }
+    samples++;
+}
+
+void ClockSync::observeTick(Uint32 tick, double serverMs) {
+    if (hasTick && tick <= referenceTick) {
+        return;
+    }
+    referenceTick = tick;
+    referenceServerMs = serverMs;
+    hasTick = true;
+}
+
+double ClockSync::estimateServerTick(double localNow) const {
+    if (!hasTick) {
+        return 0;
+    }
+    return referenceTick + (toServerMs(localNow) - referenceServerMs) / tickMs;
+}
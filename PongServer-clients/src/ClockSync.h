@@ -0,0 +1,53 @@
+#ifndef __CLOCK_SYNC_H__
+#define __CLOCK_SYNC_H__
+
+#include <deque>
+#include "SDL.h"
+
+// ClockSync: NTP-style estimate of the server's clock and tick.
+// Each PING carries the local send time; the PONG returns it with the server's time and tick.
+// A sample's offset is only as good as its round trip is symmetric, so the offset is taken from
+// the sample with the smallest RTT in a sliding window and then smoothed, which keeps queueing
+// spikes on either leg out of the estimate.
+class ClockSync {
+private:
+    struct Sample {
+        double rtt;     // Round-trip time (ms)
+        double offset;  // Server time minus local time at the midpoint of the round trip (ms)
+    };
+
+    std::deque<Sample> window;  // Most recent samples, oldest first
+    double offset = 0;          // Smoothed server - local clock offset (ms)
+    double minRtt = 0;          // Smallest RTT in the window (ms)
+    double smoothedRtt = 0;     // Smoothed RTT over all samples (ms)
+    int samples = 0;
+    double lastPing = -1e9;     // Local time the last PING was sent
+
+    Uint32 referenceTick = 0;      // Latest server tick seen...
+    double referenceServerMs = 0;  // ...and the server time it was taken at
+    bool hasTick = false;
+
+public:
+    int windowSize = 16;           // Samples considered for the minimum-RTT filter
+    double offsetGain = 0.1;       // How quickly the offset follows the filtered sample
+    double pingIntervalMs = 500;   // Time between pings once synchronised
+    double fastPingIntervalMs = 100;  // Time between the first few pings
+    int fastPings = 8;             // Samples taken at the fast interval
+    double tickMs = 1000.0 / 60;   // Server tick length, for extrapolating the tick
+
+    bool pingDue(double localNow);  // True if a PING should be sent now (records it as sent)
+    void addSample(double sentLocalMs, double serverMs, double receivedLocalMs);  // From a PONG
+    void observeTick(Uint32 tick, double serverMs);  // From a PONG or snapshot
+
+    bool isSynced() const { return samples > 0; }
+    double toLocalMs(double serverMs) const { return serverMs - offset; }
+    double toServerMs(double localMs) const { return localMs + offset; }
+    double estimateServerTick(double localNow) const;  // Fractional tick the server is on now
+
+    double getOffset() const { return offset; }
+    double getMinRtt() const { return minRtt; }
+    double getSmoothedRtt() const { return smoothedRtt; }
+    int getSampleCount() const { return samples; }
+};
+
+#endif  // __CLOCK_SYNC_H__
@@ -0,0 +1,29 @@
+#include "Crc32.h"
+
+static const Uint32 CRC32_POLYNOMIAL = 0xEDB88320;  // Reversed 0x04C11DB7
+
+// Table of the CRC of every byte value
+struct CrcTable {
+    Uint32 entries[256];
+
+    CrcTable() {
+        for (Uint32 i = 0; i < 256; i++) {
+            Uint32 c = i;
+            for (int bit = 0; bit < 8; bit++) {
+                c = (c & 1) ? (c >> 1) ^ CRC32_POLYNOMIAL : c >> 1;
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+static const CrcTable CRC_TABLE;
+
+Uint32 crc32(Uint32 crc, const void* data, size_t length) {
+    const Uint8* bytes = (const Uint8*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = CRC_TABLE.entries[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
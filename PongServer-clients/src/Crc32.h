@@ -0,0 +1,11 @@
+#ifndef __CRC32_H__
+#define __CRC32_H__
+
+#include <cstddef>
+#include "SDL.h"
+
+// CRC-32 (IEEE 802.3, the same checksum as zlib and SDL_test's SDLTest_Crc32Calc).
+// Pass the previous result as `crc` to continue a checksum over more data; start from 0.
+Uint32 crc32(Uint32 crc, const void* data, size_t length);
+
+#endif  // __CRC32_H__
@@ -0,0 +1,115 @@
+#include "DesyncDetector.h"
+#include <fstream>
+#include <iostream>
+
+void DesyncDetector::reset() {
+    rollingHash = 0;
+    lastRecorded = -1;
+    history.clear();
+    outgoing.clear();
+    waiting.clear();
+    checked = 0;
+    mismatches = 0;
+    firstMismatchTick = -1;
+}
+
+void DesyncDetector::recordTick(Sint32 tick, const PongState& state) {
+    if (tick != lastRecorded + 1) {
+        return;  // Ticks must be folded in order with none missing
+    }
+    lastRecorded = tick;
+    rollingHash = PongSim::hashState(state, rollingHash);
+
+    if (syncInterval <= 0 || tick % syncInterval != 0) {
+        return;
+    }
+    SyncPoint point;
+    point.tick = tick;
+    point.hash = rollingHash;
+    point.state = state;
+    history.push_back(point);
+    if ((int)history.size() > HISTORY_SIZE) {
+        history.pop_front();
+    }
+    outgoing.push_back(point);
+}
+
+bool DesyncDetector::takeOutgoing(SyncPoint& point) {
+    if (outgoing.empty()) {
+        return false;
+    }
+    point = outgoing.front();
+    outgoing.pop_front();
+    return true;
+}
+
+bool DesyncDetector::findLocal(Sint32 tick, SyncPoint& local) const {
+    for (const SyncPoint& candidate : history) {
+        if (candidate.tick == tick) {
+            local = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DesyncDetector::checkRemote(const SyncPoint& remote) {
+    if (remote.tick > lastRecorded) {
+        waiting.push_back(remote);  // The other side is ahead; compare once we get there
+        if ((int)waiting.size() > HISTORY_SIZE) {
+            waiting.pop_front();
+        }
+        return false;
+    }
+
+    bool reportNow = false;
+    auto check = [&](const SyncPoint& point) {
+        SyncPoint ours;
+        if (!findLocal(point.tick, ours)) {
+            return;  // Too old to compare
+        }
+        checked++;
+        if (ours.hash != point.hash) {
+            mismatches++;
+            if (firstMismatchTick < 0) {
+                firstMismatchTick = point.tick;
+                firstLocal = ours;
+                firstRemote = point;
+                reportNow = true;
+            }
+        }
+    };
+
+    // Points held back earlier may be comparable now
+    while (!waiting.empty() && waiting.front().tick <= lastRecorded) {
+        check(waiting.front());
+        waiting.pop_front();
+    }
+    check(remote);
+    return reportNow;
+}
+
+bool DesyncDetector::writeReport(const std::string& path, const std::string& inputs) const {
+    const SyncPoint& local = firstLocal;
+    const SyncPoint& remote = firstRemote;
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to write desync report to " << path << std::endl;
+        return false;
+    }
+
+    Sint32 ours[PongSim::STATE_FIELDS];
+    Sint32 theirs[PongSim::STATE_FIELDS];
+    PongSim::pack(local.state, ours);
+    PongSim::pack(remote.state, theirs);
+
+    out << "Desync at tick " << local.tick << ": local hash " << std::hex << local.hash
+        << ", remote hash " << remote.hash << std::dec << std::endl;
+    out << "Values are Q16.16 fixed point except tick and scores" << std::endl << std::endl;
+    out << "field local remote" << std::endl;
+    for (int i = 0; i < PongSim::STATE_FIELDS; i++) {
+        out << PongSim::fieldName(i) << " " << ours[i] << " " << theirs[i] << (ours[i] != theirs[i] ? "  <-- differs" : "") << std::endl;
+    }
+    out << std::endl << "Inputs" << std::endl << inputs;
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef __DESYNC_DETECTOR_H__
+#define __DESYNC_DETECTOR_H__
+
+#include <deque>
+#include <string>
+#include "SDL.h"
+#include "PongSim.h"
+
+// SyncPoint: the rolling hash and full state after one tick
+struct SyncPoint {
+    Sint32 tick = -1;
+    Uint32 hash = 0;
+    PongState state;
+};
+
+// DesyncDetector: notices when two deterministic simulations of the same match drift apart.
+// Every final tick (one that can no longer be rolled back) is folded into a rolling CRC-32 of
+// the state, so a difference at any tick changes every hash after it. Every syncInterval
+// ticks the hash and the full state are published; the other side's points are compared with
+// ours for the same tick. The first mismatch writes both states and the input history to a
+// file for offline diffing.
+class DesyncDetector {
+private:
+    static const int HISTORY_SIZE = 64;  // Published points kept for comparison
+
+    Uint32 rollingHash = 0;
+    Sint32 lastRecorded = -1;
+    std::deque<SyncPoint> history;   // Our published points, oldest first
+    std::deque<SyncPoint> outgoing;  // Published points not yet sent
+    std::deque<SyncPoint> waiting;   // Remote points for ticks we haven't reached yet
+    int checked = 0;
+    int mismatches = 0;
+    Sint32 firstMismatchTick = -1;
+    SyncPoint firstLocal;    // Both sides of the first mismatch
+    SyncPoint firstRemote;
+
+    bool findLocal(Sint32 tick, SyncPoint& local) const;  // False if the tick is no longer kept
+
+public:
+    int syncInterval = 30;  // Ticks between published hashes (0.5 s at 60 Hz)
+
+    void reset();
+    void recordTick(Sint32 tick, const PongState& state);  // Call for every final tick, in order
+    bool takeOutgoing(SyncPoint& point);  // Next point to send to the other side
+
+    // Compare a point from the other side. Returns true when this finds the first mismatch,
+    // so the caller can write a report.
+    bool checkRemote(const SyncPoint& remote);
+
+    // Write both sides of the first mismatch, the differing fields and the input history to `path`
+    bool writeReport(const std::string& path, const std::string& inputs) const;
+
+    int getChecked() const { return checked; }
+    int getMismatches() const { return mismatches; }
+    Sint32 getFirstMismatchTick() const { return firstMismatchTick; }
+};
+
+#endif  // __DESYNC_DETECTOR_H__
@@ -0,0 +1,183 @@
+#include "EventLoop.h"
+#include <iostream>
+
+EventLoop::~EventLoop() {
+    // Waiters point into coroutine frames owned by the tasks, so drop them first
+    waiters.clear();
+    readyQueue.clear();
+    tasks.clear();
+}
+
+// -------------------------------------------------
+// Awaitables
+// -------------------------------------------------
+
+bool EventLoop::WaitAwaiter::await_ready() {
+    if (waiter.cancel && waiter.cancel->isCancelled()) {
+        result = false;
+        return true;
+    }
+    if (waiter.ready && waiter.ready()) {
+        result = true;
+        return true;
+    }
+    return false;
+}
+
+void EventLoop::WaitAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    waiter.handle = handle;
+    waiter.result = &result;
+    loop->waiters.push_back(waiter);
+}
+
+EventLoop::WaitAwaiter EventLoop::until(std::function<bool()> ready, Uint32 timeoutMs, CancelToken* cancel) {
+    WaitAwaiter awaiter{ this, Waiter() };
+    awaiter.waiter.ready = std::move(ready);
+    awaiter.waiter.cancel = cancel;
+    if (timeoutMs != FOREVER) {
+        awaiter.waiter.hasDeadline = true;
+        awaiter.waiter.deadline = SDL_GetTicks() + timeoutMs;
+    }
+    return awaiter;
+}
+
+EventLoop::WaitAwaiter EventLoop::signalled(std::function<bool()> ready, Uint32 timeoutMs, CancelToken* cancel) {
+    WaitAwaiter awaiter = until(std::move(ready), timeoutMs, cancel);
+    awaiter.waiter.pollReady = wakeSignal.socket() == NO_SOCKET;  // Without a signal, fall back to polling
+    return awaiter;
+}
+
+EventLoop::WaitAwaiter EventLoop::readable(Channel& channel, Uint32 timeoutMs, CancelToken* cancel) {
+    Channel* ch = &channel;
+    WaitAwaiter awaiter = until([ch]() { return ch->hasBufferedMessage(); }, timeoutMs, cancel);
+    awaiter.waiter.transport = channel.getTransport();
+    awaiter.waiter.socket = awaiter.waiter.transport->nativeSocket();
+    return awaiter;
+}
+
+EventLoop::WaitAwaiter EventLoop::writable(Channel& channel, int length, Uint32 timeoutMs, CancelToken* cancel) {
+    Channel* ch = &channel;
+    return until([ch, length]() { return ch->canSend(length); }, timeoutMs, cancel);
+}
+
+EventLoop::WaitAwaiter EventLoop::sleep(Uint32 ms, CancelToken* cancel) {
+    WaitAwaiter awaiter = until(nullptr, ms, cancel);
+    awaiter.waiter.succeedOnTimeout = true;
+    return awaiter;
+}
+
+// -------------------------------------------------
+// Scheduling
+// -------------------------------------------------
+
+void EventLoop::spawn(Task<> task) {
+    readyQueue.push_back(task.getHandle());
+    tasks.push_back(std::move(task));
+}
+
+void EventLoop::run() {
+    stopping.store(false);
+    while (!stopping.load() && !tasks.empty()) {
+        runOnce(IDLE_WAIT_MS);
+    }
+}
+
+void EventLoop::runOnce(Uint32 maxWaitMs) {
+    // Start newly spawned coroutines
+    std::vector<std::coroutine_handle<>> resuming;
+    resuming.swap(readyQueue);
+    for (auto handle : resuming) {
+        handle.resume();
+    }
+    resuming.clear();
+
+    // Sleep until a socket is readable, wake() is called or the nearest deadline passes
+    Uint32 now = SDL_GetTicks();
+    Uint32 timeout = readyQueue.empty() ? maxWaitMs : 0;
+    poller.clear();
+    int wakeIndex = wakeSignal.socket() != NO_SOCKET ? poller.add(wakeSignal.socket(), SocketPoller::READ) : -1;
+    for (Waiter& waiter : waiters) {
+        if (waiter.socket != NO_SOCKET) {
+            waiter.pollIndex = poller.add(waiter.socket, SocketPoller::READ);
+        }
+        else if (((waiter.ready && waiter.pollReady) || waiter.transport) && timeout > POLL_INTERVAL_MS) {
+            timeout = POLL_INTERVAL_MS;  // Nothing will wake us for these, so poll them
+        }
+        if (waiter.cancel && timeout > CANCEL_POLL_MS) {
+            timeout = CANCEL_POLL_MS;
+        }
+        if (waiter.hasDeadline) {
+            Sint32 remaining = (Sint32)(waiter.deadline - now);
+            Uint32 wait = remaining > 0 ? (Uint32)remaining : 0;
+            if (wait < timeout) {
+                timeout = wait;
+            }
+        }
+    }
+
+    if (!poller.isEmpty()) {
+        if (poller.wait(timeout) > 0 && wakeIndex >= 0 && poller.ready(wakeIndex)) {
+            wakeSignal.clear();
+        }
+    }
+    else if (timeout > 0) {
+        SDL_Delay(timeout);
+    }
+
+    // Collect every waiter whose wait is over, then resume them; resumed coroutines
+    // may register new waiters, so the list is not touched while they run
+    now = SDL_GetTicks();
+    for (auto it = waiters.begin(); it != waiters.end();) {
+        bool finished = false;
+        bool satisfied = false;
+
+        if (it->cancel && it->cancel->isCancelled()) {
+            finished = true;
+        }
+        else if ((it->ready && it->ready()) ||
+                 (it->socket != NO_SOCKET && poller.ready(it->pollIndex) != 0) ||
+                 (it->transport && it->socket == NO_SOCKET && it->transport->waitReadable(0) != 0)) {
+            finished = true;
+            satisfied = true;
+        }
+        else if (it->hasDeadline && (Sint32)(now - it->deadline) >= 0) {
+            finished = true;
+            satisfied = it->succeedOnTimeout;
+        }
+
+        if (!finished) {
+            ++it;
+            continue;
+        }
+
+        *it->result = satisfied;
+        resuming.push_back(it->handle);
+        it = waiters.erase(it);
+    }
+
+    for (auto handle : resuming) {
+        handle.resume();
+    }
+
+    reapTasks();
+}
+
+// Destroy finished top-level tasks and report any that failed
+void EventLoop::reapTasks() {
+    for (auto it = tasks.begin(); it != tasks.end();) {
+        if (!it->done()) {
+            ++it;
+            continue;
+        }
+        try {
+            it->rethrowIfFailed();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Network task failed: " << e.what() << std::endl;
+        }
+        catch (...) {
+            std::cerr << "Network task failed" << std::endl;
+        }
+        it = tasks.erase(it);
+    }
+}
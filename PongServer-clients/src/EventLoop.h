@@ -0,0 +1,102 @@
+#ifndef __EVENT_LOOP_H__
+#define __EVENT_LOOP_H__
+
+#include "Task.h"
+#include "Channel.h"
+#include "NativeSocket.h"
+#include <atomic>
+#include <functional>
+#include <list>
+#include <vector>
+
+// CancelToken: cooperative cancellation for coroutines waiting on the event loop.
+// Any thread may cancel; waits holding the token finish with false on the next loop pass.
+class CancelToken {
+private:
+    std::atomic<bool> cancelled{ false };
+
+public:
+    void cancel() { cancelled.store(true); }
+    void reset() { cancelled.store(false); }
+    bool isCancelled() const { return cancelled.load(); }
+};
+
+// EventLoop: runs many coroutines on one thread.
+// Coroutines co_await socket readiness, send space, timers or arbitrary conditions;
+// the loop sleeps in poll() (see SocketPoller) until a TCP socket is readable, another
+// thread calls wake() or the nearest deadline passes, then resumes every coroutine whose wait is over. poll() has
+// no descriptor limit, so one loop can wait on as many sockets as the process may open.
+//
+// Only waits are multiplexed. A coroutine that sends on TCP or connects makes blocking
+// calls on the loop's thread: a peer that stops reading, or a slow connect, holds
+// up every other coroutine on the loop and its timers. Shared-memory channels report real
+// send space, so they never block. signalled() conditions are checked when wake() is called.
+// Waits that nothing else can end (shared memory and until() conditions) are checked every
+// POLL_INTERVAL_MS, which adds up to that much latency and wakes the thread each millisecond
+// while one is pending.
+class EventLoop {
+private:
+    struct Waiter {
+        std::coroutine_handle<> handle;  // Coroutine to resume
+        std::function<bool()> ready;     // Condition the coroutine is waiting for (may be empty)
+        Transport* transport = nullptr;  // Transport whose readability also ends the wait
+        SocketHandle socket = NO_SOCKET; // Its socket, polled for readability
+        int pollIndex = -1;              // The socket's entry in this pass's poller
+        Uint32 deadline = 0;             // SDL_GetTicks() value at which the wait times out
+        bool hasDeadline = false;
+        bool pollReady = true;           // Re-check `ready` every POLL_INTERVAL_MS; false if wake() announces it
+        bool succeedOnTimeout = false;   // Sleeps count reaching the deadline as success
+        CancelToken* cancel = nullptr;   // Optional cancellation
+        bool* result = nullptr;          // Set to true if the wait ended because it was satisfied
+    };
+
+    // Awaitable returned by the wait functions; co_await yields true if satisfied,
+    // false on timeout or cancellation
+    struct WaitAwaiter {
+        EventLoop* loop;
+        Waiter waiter;
+        bool result = false;
+
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        bool await_resume() const { return result; }
+    };
+
+    SocketPoller poller;                   // Sockets of waiters blocked on readability, rebuilt each pass
+    WakeSignal wakeSignal;                 // Raised by wake() from any thread
+    std::list<Waiter> waiters;             // Suspended coroutines
+    std::list<Task<>> tasks;               // Spawned top-level coroutines owned by the loop
+    std::vector<std::coroutine_handle<>> readyQueue;  // Coroutines to resume on the next pass
+    std::atomic<bool> stopping{ false };
+
+    void reapTasks();
+
+public:
+    static const Uint32 FOREVER = 0xFFFFFFFF;  // No timeout
+    static const Uint32 POLL_INTERVAL_MS = 1;  // Re-check interval for conditions without a socket
+    static const Uint32 CANCEL_POLL_MS = 10;   // Re-check interval for cancellable waits
+    static const Uint32 IDLE_WAIT_MS = 100;    // Longest single wait, so stop() is noticed
+
+    EventLoop() {}
+    ~EventLoop();
+
+    void spawn(Task<> task);  // Start a coroutine owned by the loop
+    void run();               // Run until every spawned task has finished or stop() is called
+    void runOnce(Uint32 maxWaitMs);  // One pass: wait for events, then resume ready coroutines
+    void stop() { stopping.store(true); }
+    void wake() { wakeSignal.raise(); }  // Thread-safe: re-check signalled() conditions now
+    bool hasTasks() const { return !tasks.empty(); }
+
+    // Wait until `ready` returns true
+    WaitAwaiter until(std::function<bool()> ready, Uint32 timeoutMs = FOREVER, CancelToken* cancel = nullptr);
+    // Wait until `ready` returns true, checking it only when wake() is called or the loop wakes for something else
+    WaitAwaiter signalled(std::function<bool()> ready, Uint32 timeoutMs = FOREVER, CancelToken* cancel = nullptr);
+    // Wait until a message can be read from the channel without blocking
+    WaitAwaiter readable(Channel& channel, Uint32 timeoutMs = FOREVER, CancelToken* cancel = nullptr);
+    // Wait until the channel can take a message of `length` bytes without blocking (always at once on TCP)
+    WaitAwaiter writable(Channel& channel, int length, Uint32 timeoutMs = FOREVER, CancelToken* cancel = nullptr);
+    // Sleep; yields false if cancelled early
+    WaitAwaiter sleep(Uint32 ms, CancelToken* cancel = nullptr);
+};
+
+#endif  // __EVENT_LOOP_H__
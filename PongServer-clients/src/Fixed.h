@@ -0,0 +1,21 @@
+#ifndef __FIXED_H__
+#define __FIXED_H__
+
+#include <cmath>
+#include "SDL.h"
+
+// Q16.16 fixed-point numbers for the simulation.
+// Only integer arithmetic is used once values are converted, so every client (and compiler)
+// produces bit-identical results from the same inputs.
+typedef Sint32 Fixed;
+
+const int FIXED_SHIFT = 16;
+const Fixed FIXED_ONE = 1 << FIXED_SHIFT;
+
+inline Fixed fixedFromInt(int value) { return value * FIXED_ONE; }
+inline Fixed fixedFromDouble(double value) { return (Fixed)std::lround(value * FIXED_ONE); }
+inline float fixedToFloat(Fixed value) { return value / (float)FIXED_ONE; }
+inline Fixed fixedAbs(Fixed value) { return value < 0 ? -value : value; }
+inline int fixedSign(Fixed value) { return (value > 0) - (value < 0); }
+
+#endif  // __FIXED_H__
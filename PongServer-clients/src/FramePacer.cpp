@@ -0,0 +1,95 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <iostream>
+
+static const double VSYNC_MISS_FACTOR = 1.5;  // A VSync frame this many refresh intervals long missed a vblank
+
+FramePacer::FramePacer() {
+    frequency = SDL_GetPerformanceFrequency();
+}
+
+Uint32 FramePacer::rendererFlags() const {
+    return mode == PACE_VSYNC ? SDL_RENDERER_PRESENTVSYNC : 0;
+}
+
+void FramePacer::start() {
+    lastFrameEnd = SDL_GetPerformanceCounter();
+    deadline = lastFrameEnd + (Uint64)(frequency / targetFps);
+}
+
+bool FramePacer::waitForDeadline() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 period = (Uint64)(frequency / targetFps);
+    bool late = now > deadline;
+    if (late) {
+        // Already late: start a new schedule instead of running short frames to catch up
+        deadline = now;
+    }
+    else {
+        // Sleep off most of the wait, then spin for the precise moment
+        double remainingMs = toMs(deadline - now);
+        if (remainingMs > spinMarginMs) {
+            SDL_Delay((Uint32)(remainingMs - spinMarginMs));
+        }
+        while (SDL_GetPerformanceCounter() < deadline) {
+        }
+    }
+    deadline += period;
+    return late;
+}
+
+void FramePacer::skipFrame() {
+    // Without a present there is no vblank to wait for, so VSync mode waits like a fixed cap
+    if (mode != PACE_UNCAPPED) {
+        if (mode == PACE_VSYNC && deadline < lastFrameEnd) {
+            deadline = lastFrameEnd + (Uint64)(frequency / targetFps);
+        }
+        waitForDeadline();
+    }
+    lastFrameEnd = SDL_GetPerformanceCounter();
+}
+
+void FramePacer::endFrame() {
+    if (mode == PACE_FIXED && waitForDeadline()) {
+        missedDeadlines++;
+    }
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    double frameMs = toMs(now - lastFrameEnd);
+    lastFrameEnd = now;
+    if (mode == PACE_VSYNC && frameMs > VSYNC_MISS_FACTOR * getFrameMs()) {
+        missedDeadlines++;
+    }
+
+    frameTimes[historyNext] = frameMs;
+    historyNext = (historyNext + 1) % HISTORY_SIZE;
+    if (historyCount < HISTORY_SIZE) {
+        historyCount++;
+    }
+    frames++;
+}
+
+FrameStats FramePacer::getStats() const {
+    FrameStats stats;
+    stats.frames = frames;
+    stats.missedDeadlines = missedDeadlines;
+    if (historyCount == 0) {
+        return stats;
+    }
+
+    double sorted[HISTORY_SIZE];
+    std::copy(frameTimes, frameTimes + historyCount, sorted);
+    std::sort(sorted, sorted + historyCount);
+    stats.p50Ms = sorted[(historyCount - 1) / 2];
+    stats.p99Ms = sorted[(historyCount - 1) * 99 / 100];
+    stats.maxMs = sorted[historyCount - 1];
+    return stats;
+}
+
+void FramePacer::printStats() const {
+    static const char* MODE_NAMES[] = { "vsync", "uncapped", "fixed" };
+    FrameStats stats = getStats();
+    std::cout << "Frames (" << MODE_NAMES[mode] << ", target " << getFrameMs() << " ms): p50 " << stats.p50Ms
+              << " ms, p99 " << stats.p99Ms << " ms, max " << stats.maxMs << " ms, " << stats.missedDeadlines
+              << " missed deadlines in " << stats.frames << " frames" << std::endl;
+}
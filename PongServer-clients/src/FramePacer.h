@@ -0,0 +1,62 @@
+#ifndef __FRAME_PACER_H__
+#define __FRAME_PACER_H__
+
+#include "SDL.h"
+
+enum PaceMode {
+    PACE_VSYNC,     // Present waits for the display's vertical blank
+    PACE_UNCAPPED,  // Frames run back to back
+    PACE_FIXED      // Frames start on a fixed-rate schedule of performance counter deadlines
+};
+
+// FrameStats: frame times over the recent window plus totals since the pacer started
+struct FrameStats {
+    double p50Ms = 0;       // Median frame time
+    double p99Ms = 0;       // 99th percentile frame time
+    double maxMs = 0;       // Longest frame in the window
+    int frames = 0;         // Frames paced so far
+    int missedDeadlines = 0;  // Frames that finished after their deadline
+};
+
+// FramePacer: decides when the next frame may start and measures how long frames take.
+// In fixed mode each frame has a deadline on the performance counter. SDL_Delay only has
+// millisecond granularity and often oversleeps, so the pacer sleeps until spinMarginMs before
+// the deadline and busy-waits the rest. A frame that is already late when it ends counts as a
+// missed deadline and the schedule restarts from now, rather than rushing to catch up.
+// In VSync mode the wait happens inside SDL_RenderPresent; a frame longer than 1.5 refresh
+// intervals is counted as a missed vblank.
+class FramePacer {
+private:
+    static const int HISTORY_SIZE = 512;  // Frame times kept for the percentiles
+
+    double frameTimes[HISTORY_SIZE] = {};  // Ring of recent frame times (ms)
+    int historyCount = 0;
+    int historyNext = 0;
+
+    Uint64 frequency;          // Performance counter ticks per second
+    Uint64 lastFrameEnd = 0;   // Counter when the previous frame finished waiting
+    Uint64 deadline = 0;       // Fixed mode: counter value the next frame may start at
+    int frames = 0;
+    int missedDeadlines = 0;
+
+    double toMs(Uint64 ticks) const { return ticks * 1000.0 / frequency; }
+    bool waitForDeadline();  // Sleep and spin until the deadline, then schedule the next; true if already late
+
+public:
+    PaceMode mode = PACE_VSYNC;
+    double targetFps = 60;     // Fixed mode frame rate; VSync mode's expected refresh rate
+    double spinMarginMs = 1;   // Fixed mode: stop sleeping this long before the deadline and spin
+
+    FramePacer();
+
+    Uint32 rendererFlags() const;  // Flags to add to SDL_CreateRenderer for this mode
+    void start();                  // Begin timing from now
+    void endFrame();               // Call after presenting: waits for the next frame slot and records the frame time
+    void skipFrame();              // Call instead when nothing was drawn: waits for the slot without recording it
+    FrameStats getStats() const;   // Percentiles over the last HISTORY_SIZE frames
+    void printStats() const;       // Write the statistics to stdout
+
+    double getFrameMs() const { return 1000.0 / targetFps; }
+};
+
+#endif  // __FRAME_PACER_H__
@@ -0,0 +1,35 @@
+#ifndef __FRAME_PACKET_H__
+#define __FRAME_PACKET_H__
+
+#include <string>
+#include <vector>
+#include "SDL.h"
+#include "SpriteAtlas.h"
+
+// FramePacket: everything needed to draw one frame, built by the main thread and read-only
+// afterwards. The render thread draws it without touching game state.
+struct FramePacket {
+    struct SpriteItem {
+        Sprite sprite;
+        SDL_Rect target;
+        int layer;
+    };
+
+    struct TextItem {
+        std::string text;
+        SDL_Rect rect;  // Only x and y are used; the text is drawn at its natural size
+    };
+
+    std::vector<SpriteItem> sprites;
+    std::vector<TextItem> texts;
+
+    Uint32 frame = 0;      // Sequence number, counting every packet submitted
+    double builtAt = 0;    // nowMs() when the main thread finished building it
+    double simulateMs = 0; // Main thread time spent on events, update and ticks for this frame
+    double buildMs = 0;    // Main thread time spent building the packet
+
+    void addSprite(const Sprite& sprite, const SDL_Rect& target, int layer) { sprites.push_back({ sprite, target, layer }); }
+    void addText(const std::string& text, int x, int y) { texts.push_back({ text, { x, y, 0, 0 } }); }
+};
+
+#endif  // __FRAME_PACKET_H__
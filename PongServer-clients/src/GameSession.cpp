@@ -0,0 +1,680 @@
+#include "GameSession.h"
+#include "Timing.h"
+#include <cmath>
+#include <iostream>
+#include <map>
+
+// -------------------------------------------------
+// Constants
+// -------------------------------------------------
+
+// Local prediction limits
+static const double MAX_CATCH_UP_MS = 250;  // Longest snapshot age the ball is run forward by
+static const float TELEPORT_DISTANCE = 100;  // Moves larger than this in one tick are drawn without blending
+// The same event's effect plays at most once in this window. Long enough to cover a server
+// event arriving after the predicted one, and still shorter than the ball takes to come back
+static const double EFFECT_REPEAT_MS = 400;
+static const double SCORE_CONFIRM_MS = 500;  // A server score within this of a predicted one is not replayed
+
+// Server event messages and the simulation events they correspond to
+static const std::map<std::string, int> SERVER_EVENTS = {
+    { "HIT_WALL_LEFT", EVENT_HIT_WALL_LEFT },
+    { "HIT_WALL_RIGHT", EVENT_HIT_WALL_RIGHT },
+    { "HIT_WALL_UP", EVENT_HIT_WALL_UP },
+    { "HIT_WALL_DOWN", EVENT_HIT_WALL_DOWN },
+    { "BALL_HIT_BAT1", EVENT_BALL_HIT_BAT1 },
+    { "BALL_HIT_BAT2", EVENT_BALL_HIT_BAT2 },
+};
+
+// -------------------------------------------------
+// GameSession Class Methods
+// -------------------------------------------------
+
+GameSession::GameSession() : tickMs(1000.0 / PaddleRules::TICK_RATE), inputTiming(tickMs) {
+}
+
+// Handle received game data from server
+void GameSession::on_receive(std::string cmd, std::vector<std::string>& args) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+
+    if (cmd == "GAME_DATA" && rollback.isStarted()) {
+        // The rollback simulation is authoritative for this client; only the slot is needed
+        if (args.size() >= 9) {
+            game_data.connectionID = std::stoi(args.at(6));
+        }
+    }
+    else if (cmd == "ROLLBACK_START") {
+        // ROLLBACK_START,<player>,<input delay>: both players begin at tick 0 now
+        if (args.size() >= 2) {
+            rollback.rollbackWindow = rollbackWindow;
+            rollback.start(std::stoi(args.at(0)) - 1, std::stoi(args.at(1)));
+            desync.reset();
+            lastHashedTick = -1;
+            std::cout << "Rollback match started as player " << args.at(0) << " with " << args.at(1) << " ticks of input delay" << std::endl;
+        }
+    }
+    else if (cmd == "ROLLBACK_STOP") {
+        // The other player left; rejoin so a new match starts when someone takes their place
+        rollback.stop();
+        rollbackJoined = false;
+        std::cout << "Rollback match stopped: the other player disconnected" << std::endl;
+    }
+    else if (cmd == "PEER_INPUT") {
+        // PEER_INPUT,<tick>,<buttons>,<tick>,<buttons>,...
+        for (size_t i = 0; i + 1 < args.size(); i += 2) {
+            rollback.addRemoteInput(std::stoi(args.at(i)), std::stoi(args.at(i + 1)));
+        }
+    }
+    else if (cmd == "PEER_SYNC") {
+        // PEER_SYNC,<tick>,<rolling hash>,<state fields>: the other player's simulation at a sync point
+        if (args.size() >= 2 + PongSim::STATE_FIELDS) {
+            SyncPoint remote;
+            remote.tick = (Sint32)std::stol(args.at(0));
+            remote.hash = (Uint32)std::stoul(args.at(1));
+            Sint32 fields[PongSim::STATE_FIELDS];
+            for (int i = 0; i < PongSim::STATE_FIELDS; i++) {
+                fields[i] = (Sint32)std::stol(args.at(2 + i));
+            }
+            PongSim::unpack(fields, remote.state);
+
+            if (desync.checkRemote(remote)) {
+                Sint32 tick = desync.getFirstMismatchTick();
+                std::string path = desyncReportPrefix + "_tick" + std::to_string(tick) + ".txt";
+                std::cerr << "Desync with the other player at tick " << tick << ", report written to " << path << std::endl;
+                desync.writeReport(path, rollback.describeInputs(tick - 2 * PaddleRules::TICK_RATE, rollback.getTick() - 1));
+            }
+        }
+    }
+    else if (cmd == "PONG") {
+        // PONG,<our send time>,<server time>,<server tick>
+        if (args.size() >= 3) {
+            bool wasSynced = clock.isSynced();
+            clock.addSample(std::stod(args.at(0)), std::stod(args.at(1)), nowMs());
+            clock.observeTick((Uint32)std::stoul(args.at(2)), std::stod(args.at(1)));
+            if (!wasSynced) {
+                snapshots.clear();  // Switch from arrival to server timestamps
+            }
+        }
+    }
+    else if (SERVER_EVENTS.count(cmd)) {
+        // HIT_WALL_* / BALL_HIT_BAT*: sound it now, from the network thread, unless the
+        // prediction got there first
+        if (!rollback.isStarted()) {
+            playEffects(SERVER_EVENTS.at(cmd), nowMs());
+        }
+    }
+    else if (cmd == "SCORES") {
+        // SCORES,<player 1>,<player 2>: sent the moment a point is scored
+        if (args.size() >= 2 && !rollback.isStarted()) {
+            game_data.player1Score = std::stoi(args.at(0));
+            game_data.player2Score = std::stoi(args.at(1));
+            checkAndPlayScoreSound(nowMs());
+        }
+    }
+    else if (cmd == "GAME_DATA") {
+        if (args.size() >= 9) {
+            // Update the game state with server data (player positions, scores, etc.)
+            game_data.player1Y = std::stof(args.at(0));
+            game_data.player2Y = std::stof(args.at(1));
+            game_data.ballX = std::stof(args.at(2));
+            game_data.ballY = std::stof(args.at(3));
+            game_data.player1X = std::stof(args.at(4));
+            game_data.player2X = std::stof(args.at(5));
+            game_data.connectionID = std::stoi(args.at(6));
+            game_data.player1Score = std::stoi(args.at(7));
+            game_data.player2Score = std::stoi(args.at(8));
+            if (args.size() >= 10) {
+                game_data.inputAck = (Uint32)std::stoul(args.at(9));  // Last INPUT applied to our paddle
+            }
+            if (args.size() >= 12) {
+                game_data.ballVX = std::stof(args.at(10));
+                game_data.ballVY = std::stof(args.at(11));
+                game_data.hasBallVelocity = true;
+            }
+            if (args.size() >= 14) {
+                game_data.serverTimeMs = std::stod(args.at(13));
+                game_data.hasServerTime = true;
+                clock.observeTick((Uint32)std::stoul(args.at(12)), game_data.serverTimeMs);
+            }
+            if (args.size() >= 15) {
+                game_data.inputMarginMs = std::stod(args.at(14));
+                game_data.hasInputMargin = true;
+            }
+            if (!game_data.hasServerUpdate) {
+                startup.mark("first snapshot received");  // Kept only the first time
+            }
+            game_data.hasServerUpdate = true;
+            snapshotsReceived++;
+            double arrival = nowMs();
+            checkAndPlayBallHitSound(arrival);
+            checkAndPlayScoreSound(arrival);
+
+            // Buffer the positions at full precision; update() draws them interpDelay ms later.
+            // Once the clock is synced they are placed on the server's timeline, so network
+            // jitter shows up as transit variation instead of uneven motion.
+            Snapshot snapshot;
+            snapshot.time = clock.isSynced() && game_data.hasServerTime ? clock.toLocalMs(game_data.serverTimeMs) : arrival;
+            snapshot.player1Y = game_data.player1Y;
+            snapshot.player2Y = game_data.player2Y;
+            snapshot.ballX = game_data.ballX;
+            snapshot.ballY = game_data.ballY;
+            snapshot.player1X = game_data.player1X;
+            snapshot.player2X = game_data.player2X;
+            snapshots.push(snapshot, arrival);
+        }
+    }
+
+    publishSnapshotEvent();
+}
+
+// Post one wake-up event for any number of messages received before the main loop runs
+void GameSession::publishSnapshotEvent() {
+    if (snapshotEventType == 0 || snapshotEventQueued.exchange(true)) {
+        return;
+    }
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = snapshotEventType;
+    if (SDL_PushEvent(&event) <= 0) {
+        snapshotEventQueued = false;
+    }
+}
+
+// The handshake tells us which paddle is ours before the first snapshot arrives
+void GameSession::on_session(const SessionInfo& session) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    startup.mark("connected and handshake finished");
+
+    game_data.playerID = session.playerSlot;
+    game_data.connectionID = session.playerSlot;
+    if (session.tickRate > 0) {
+        clock.tickMs = 1000.0 / session.tickRate;
+    }
+    if (session.tickRate > 0 && std::fabs(1000.0 / session.tickRate - tickMs) > 0.01) {
+        std::cerr << "Server runs at " << session.tickRate << " Hz but the client simulates at " << 1000.0 / tickMs << " Hz" << std::endl;
+    }
+
+    // After a reconnect the next GAME_DATA is a full keyframe; drop what was buffered from
+    // the old connection and rejoin a rollback match, which the server restarts
+    snapshots.clear();
+    game_data.hasServerUpdate = false;
+    soundedScores[0] = soundedScores[1] = -1;  // The keyframe's scores are adopted silently
+    snapshotScores[0] = snapshotScores[1] = -1;
+    if (rollbackMode) {
+        rollback.stop();
+        rollbackJoined = false;
+    }
+}
+
+// Send messages to the server
+void GameSession::send(std::string message) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    queueMessage(std::move(message));
+}
+
+void GameSession::queueMessage(std::string message) {
+    messages.push_back(std::move(message));
+    if (sendNotifier) {
+        sendNotifier();
+    }
+}
+
+void GameSession::setSendNotifier(std::function<void()> notify) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    sendNotifier = std::move(notify);
+}
+
+// Move the queued messages to the network thread; returns false if there were none
+bool GameSession::takeMessages(std::vector<std::string>& outgoing) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (messages.empty()) {
+        return false;
+    }
+    outgoing.swap(messages);
+    messages.clear();
+    return true;
+}
+
+// Handle player input (keyboard events)
+void GameSession::input(SDL_Event& event) {
+    switch (event.key.keysym.sym) {
+    case SDLK_w:
+        if (event.type == SDL_KEYDOWN) {
+            game_data.moveUp = true;
+        }
+        else if (event.type == SDL_KEYUP) {
+            game_data.moveUp = false;
+        }
+        break;
+
+    case SDLK_s:
+        if (event.type == SDL_KEYDOWN) {
+            game_data.moveDown = true;
+        }
+        else if (event.type == SDL_KEYUP) {
+            game_data.moveDown = false;
+        }
+        break;
+    }
+}
+
+// Play the score sound when a score goes up, unless it played for this point already (a
+// predicted score, or the server's SCORES before its GAME_DATA). Called with stateMutex held
+// wherever the scores change; the first scores seen are adopted without a sound
+void GameSession::checkAndPlayScoreSound(double eventTime) {
+    int scores[2] = { game_data.player1Score, game_data.player2Score };
+    bool alreadyPlayed = eventTime - lastScoreSoundTime < SCORE_CONFIRM_MS;
+    for (int i = 0; i < 2; i++) {
+        if (soundedScores[i] >= 0 && scores[i] > soundedScores[i] && !alreadyPlayed) {
+            // Player 1 scores when the ball reaches the right wall, player 2 at the left
+            playEffects(i == 0 ? EVENT_HIT_WALL_RIGHT : EVENT_HIT_WALL_LEFT, eventTime);
+        }
+        soundedScores[i] = scores[i];
+    }
+}
+
+// Find bounces in the server's ball velocity: a reversed horizontal direction between two
+// snapshots is a bat hit and a reversed vertical one a wall hit. This catches hits that
+// neither a server event nor the prediction sounded; playEffects drops the rest.
+// Called from on_receive with stateMutex held
+void GameSession::checkAndPlayBallHitSound(double eventTime) {
+    if (!game_data.hasBallVelocity) {
+        return;
+    }
+    int events = 0;
+    if (snapshotBallVX != 0 && game_data.ballVX != 0 && (snapshotBallVX > 0) != (game_data.ballVX > 0)) {
+        events |= game_data.ballVX > 0 ? EVENT_BALL_HIT_BAT1 : EVENT_BALL_HIT_BAT2;
+    }
+    if (snapshotBallVY != 0 && game_data.ballVY != 0 && (snapshotBallVY > 0) != (game_data.ballVY > 0)) {
+        events |= game_data.ballVY > 0 ? EVENT_HIT_WALL_UP : EVENT_HIT_WALL_DOWN;
+    }
+    snapshotBallVX = game_data.ballVX;
+    snapshotBallVY = game_data.ballVY;
+
+    // A point resets the ball, which is not a bounce. The scores are compared with the previous
+    // snapshot's, since SCORES arrives before this GAME_DATA and has already moved soundedScores
+    bool scored = game_data.player1Score != snapshotScores[0] || game_data.player2Score != snapshotScores[1];
+    snapshotScores[0] = game_data.player1Score;
+    snapshotScores[1] = game_data.player2Score;
+    if (!scored) {
+        playEffects(events, eventTime);
+    }
+}
+
+// Predict one tick of local paddle movement and queue that tick's input for the server
+// Called from update() with stateMutex held
+void GameSession::playerMovement() {
+    int buttons = (game_data.moveUp ? PaddleRules::UP : 0) | (game_data.moveDown ? PaddleRules::DOWN : 0);
+    Uint32 seq = predictor.tick(buttons);
+
+    // Held keys are sent every tick so the server applies exactly the ticks we predicted;
+    // an idle paddle only needs to report the release
+    if (buttons != 0 || buttons != game_data.lastSentButtons) {
+        queueMessage("INPUT," + std::to_string(seq) + "," + std::to_string(buttons));
+        game_data.lastSentButtons = buttons;
+    }
+}
+
+// -------------------------------------------------
+// Ball Prediction
+// -------------------------------------------------
+
+// Use the latest known paddle positions: our own prediction and the server's for the other one
+static void syncPaddles(PongState& state, const PaddlePredictor& predictor, int localPlayer,
+                        float player1X, float player1Y, float player2X, float player2Y) {
+    state.paddleX[0] = fixedFromDouble(player1X);
+    state.paddleX[1] = fixedFromDouble(player2X);
+    state.paddleY[0] = fixedFromDouble(localPlayer == 1 && predictor.isInitialised() ? predictor.getSimY() : player1Y);
+    state.paddleY[1] = fixedFromDouble(localPlayer == 2 && predictor.isInitialised() ? predictor.getSimY() : player2Y);
+}
+
+// Advance the predicted ball one tick (stateMutex held)
+void GameSession::predictBall() {
+    syncPaddles(ballSim.state, predictor, game_data.connectionID,
+                game_data.player1X, game_data.player1Y, game_data.player2X, game_data.player2Y);
+    ballSim.limitVelocity();
+    ballSim.moveBall();
+    checkBallWallCollision();
+    checkBallPaddleCollision();
+    ballSim.recentreIfOffscreen();
+}
+
+// Bounce the predicted ball off the walls, playing hit and score effects straight away
+void GameSession::checkBallWallCollision() {
+    playEffects(ballSim.collideWalls(), nowMs());
+}
+
+// Bounce the predicted ball off the paddles, playing the hit effect straight away
+void GameSession::checkBallPaddleCollision() {
+    playEffects(ballSim.collidePaddles(), nowMs());
+}
+
+// Start from the snapshot's ball and run it forward by the prediction lead. The
+// prediction always adopts the result; the jump is hidden by a decaying offset.
+void GameSession::correctBall() {
+    PongSim authority;
+    authority.setTickRate(ballSim.getTickRate());
+    authority.state = ballSim.state;
+    authority.state.ballX = fixedFromDouble(game_data.ballX);
+    authority.state.ballY = fixedFromDouble(game_data.ballY);
+    authority.state.ballVX = fixedFromDouble(game_data.ballVX / ballSim.getTickRate());  // px/s to px per tick
+    authority.state.ballVY = fixedFromDouble(game_data.ballVY / ballSim.getTickRate());
+    syncPaddles(authority.state, predictor, game_data.connectionID,
+                game_data.player1X, game_data.player1Y, game_data.player2X, game_data.player2Y);
+
+    // Run forward by the snapshot's age, measured on the synced clock when there is one
+    double leadMs = predictionLeadMs;
+    if (clock.isSynced() && game_data.hasServerTime) {
+        leadMs = std::min(MAX_CATCH_UP_MS, std::max(0.0, nowMs() - clock.toLocalMs(game_data.serverTimeMs)));
+    }
+    int events = 0;
+    int leadTicks = (int)std::lround(leadMs / tickMs);
+    for (int i = 0; i < leadTicks; i++) {
+        events |= authority.stepBall();
+    }
+
+    float dx = fixedToFloat(ballSim.state.ballX - authority.state.ballX);
+    float dy = fixedToFloat(ballSim.state.ballY - authority.state.ballY);
+    if (std::fabs(dx) > ballTolerance || std::fabs(dy) > ballTolerance) {
+        ballCorrections++;
+    }
+    ballErrorX += dx;
+    ballErrorY += dy;
+    prevBallX -= dx;  // The previous tick moves with the correction, like the drawn position
+    prevBallY -= dy;
+    if (std::hypot(ballErrorX, ballErrorY) > ballSnapDistance) {
+        ballErrorX = ballErrorY = 0;
+        prevBallX = fixedToFloat(authority.state.ballX);
+        prevBallY = fixedToFloat(authority.state.ballY);
+    }
+
+    ballSim.state.ballX = authority.state.ballX;
+    ballSim.state.ballY = authority.state.ballY;
+    ballSim.state.ballVX = authority.state.ballVX;
+    ballSim.state.ballVY = authority.state.ballVY;
+
+    // Bounces the prediction missed still get their effect, unless it has just played
+    playEffects(events, nowMs());
+}
+
+// Trigger the effect of each event, skipping events whose effect played moments ago.
+// eventTime is when the event happened or reached us, for the event-to-audio latency
+void GameSession::playEffects(int events, double eventTime) {
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        int event = 1 << i;
+        if (!(events & event) || eventTime - lastEffectTime[i] < EFFECT_REPEAT_MS) {
+            continue;
+        }
+        lastEffectTime[i] = eventTime;
+        effectsPlayed++;
+
+        if (event == EVENT_HIT_WALL_LEFT || event == EVENT_HIT_WALL_RIGHT) {
+            lastScoreSoundTime = eventTime;
+        }
+        onEffect(event, eventTime);
+    }
+}
+
+// Take in the latest server data once per frame; the simulation itself advances in tick()
+void GameSession::update() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+
+    // Keep the server clock estimate fresh
+    double frameStart = nowMs();
+    if (clock.pingDue(frameStart)) {
+        queueMessage("PING," + std::to_string(frameStart));
+    }
+    if (latencyLogIntervalMs > 0 && clock.isSynced() && frameStart - lastLatencyLog >= latencyLogIntervalMs) {
+        std::cout << "Latency: RTT " << clock.getSmoothedRtt() << " ms (min " << clock.getMinRtt() << " ms), clock offset "
+                  << clock.getOffset() << " ms, server tick ~" << (long)clock.estimateServerTick(frameStart)
+                  << ", snapshot transit " << snapshots.getMeanTransit() << " ms, render delay "
+                  << snapshots.getInterpDelay() << " ms, input margin " << inputTiming.getSmoothedMargin()
+                  << " ms (tick " << inputTiming.getTickMs() << " ms)" << std::endl;
+        lastLatencyLog = frameStart;
+    }
+
+    double elapsed = lastUpdateTime < 0 ? 0 : frameStart - lastUpdateTime;
+    lastUpdateTime = frameStart;
+
+    if (rollbackMode) {
+        updateRollback();
+        return;
+    }
+
+    // Ball and remote paddles come from the jitter buffer, drawn slightly in the past
+    Snapshot view;
+    if (snapshots.sample(frameStart, view)) {
+        if (!game_data.hasBallVelocity) {
+            ball.x = (int)std::lround(view.ballX);
+            ball.y = (int)std::lround(view.ballY);
+        }
+        player1.x = (int)std::lround(view.player1X);
+        player2.x = (int)std::lround(view.player2X);
+        if (game_data.connectionID != 1) {
+            player1.y = (int)std::lround(view.player1Y);
+        }
+        if (game_data.connectionID != 2) {
+            player2.y = (int)std::lround(view.player2Y);
+        }
+    }
+
+    // Rewind the local paddle to the server's position and replay unacknowledged input
+    int localPlayer = game_data.connectionID;
+    bool ownsPaddle = localPlayer == 1 || localPlayer == 2;
+    if (ownsPaddle && game_data.hasServerUpdate) {
+        predictor.reconcile(game_data.inputAck, localPlayer == 1 ? game_data.player1Y : game_data.player2Y);
+    }
+
+    // Each newly acknowledged input says how early it arrived; steer the tick rate with it
+    if (game_data.hasInputMargin && game_data.inputAck != lastTimedAck) {
+        inputTiming.onReport(game_data.inputMarginMs);
+        lastTimedAck = game_data.inputAck;
+    }
+
+    // Same for the ball, which is then predicted ahead of the snapshots
+    if (game_data.hasBallVelocity && game_data.hasServerUpdate) {
+        correctBall();
+    }
+    game_data.hasServerUpdate = false;
+
+    // Corrections fade out in real time, whatever the tick and frame rates
+    predictor.decayError(elapsed);
+    if (game_data.hasBallVelocity) {
+        float decay = (float)std::pow(0.5, elapsed / ballErrorHalfLifeMs);
+        ballErrorX *= decay;
+        ballErrorY *= decay;
+    }
+}
+
+// Advance the local simulation by one fixed tick: the predicted paddle (queueing its input for
+// the server) and the predicted ball, or the rollback match
+bool GameSession::tick() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+
+    if (rollbackMode) {
+        return tickRollback();
+    }
+
+    playerMovement();
+    if (game_data.hasBallVelocity) {
+        prevBallX = fixedToFloat(ballSim.state.ballX);
+        prevBallY = fixedToFloat(ballSim.state.ballY);
+        predictBall();
+    }
+    return true;
+}
+
+// Rollback mode's per-frame work: joining the match and reporting on it (stateMutex held)
+void GameSession::updateRollback() {
+    if (!rollbackJoined) {
+        queueMessage("ROLLBACK_JOIN," + std::to_string(inputDelay));
+        rollbackJoined = true;
+    }
+    if (!rollback.isStarted()) {
+        return;  // Waiting for the other player
+    }
+
+    const PongState& state = rollback.getState();
+    game_data.player1Score = state.score[0];
+    game_data.player2Score = state.score[1];
+    checkAndPlayScoreSound(nowMs());  // Normally already sounded by the tick that scored
+
+    double now = nowMs();
+    if (rollbackLogIntervalMs > 0 && now - lastRollbackLog >= rollbackLogIntervalMs) {
+        const RollbackStats& stats = rollback.getStats();
+        std::cout << "Rollback: tick " << rollback.getTick() << ", " << stats.rollbacks << " rollbacks ("
+                  << stats.resimulatedTicks << " ticks resimulated, deepest " << stats.maxRollbackDepth << "), "
+                  << stats.mispredictedInputs << " mispredicted inputs, " << stats.stalls << " stalls, "
+                  << stats.predictedTicks << " ticks ahead, " << desync.getChecked() << " sync points checked, "
+                  << desync.getMismatches() << " desynced" << std::endl;
+        lastRollbackLog = now;
+    }
+}
+
+// Run one tick of the rollback match; false while stalled on the other player (stateMutex held)
+bool GameSession::tickRollback() {
+    if (!rollback.isStarted()) {
+        return false;
+    }
+
+    int buttons = (game_data.moveUp ? PaddleRules::UP : 0) | (game_data.moveDown ? PaddleRules::DOWN : 0);
+    Sint32 tick = rollback.addLocalInput(buttons);
+    if (tick >= 0) {
+        queueMessage("FRAME," + std::to_string(tick) + "," + std::to_string(buttons));
+    }
+
+    PongState before = rollback.getState();
+    int events = rollback.advance();
+    if (events < 0) {
+        return false;
+    }
+    prevRollbackState = before;
+    playEffects(events, nowMs());
+
+    // Hash every tick that can no longer change and publish the periodic sync points
+    Sint32 finalTick = rollback.getFinalTick();
+    PongState finalState;
+    while (lastHashedTick < finalTick && rollback.getStateAfter(lastHashedTick + 1, finalState)) {
+        desync.recordTick(++lastHashedTick, finalState);
+    }
+    SyncPoint point;
+    while (desync.takeOutgoing(point)) {
+        Sint32 fields[PongSim::STATE_FIELDS];
+        PongSim::pack(point.state, fields);
+        std::string message = "SYNC," + std::to_string(point.tick) + "," + std::to_string(point.hash);
+        for (int i = 0; i < PongSim::STATE_FIELDS; i++) {
+            message += "," + std::to_string(fields[i]);
+        }
+        queueMessage(message);
+    }
+    return true;
+}
+
+// Blend between the state before and after the latest tick
+static float between(float previous, float current, float alpha) {
+    if (std::fabs(current - previous) > TELEPORT_DISTANCE) {
+        return current;  // Recentred or snapped: don't draw it sliding across the screen
+    }
+    return previous + (current - previous) * alpha;
+}
+
+// Position the locally simulated objects alpha of the way from the previous tick to the latest
+void GameSession::updateRects(float alpha) {
+    if (rollbackMode) {
+        if (!rollback.isStarted()) {
+            return;
+        }
+        const PongState& state = rollback.getState();
+        const PongState& prev = prevRollbackState;
+        ball.x = (int)std::lround(between(fixedToFloat(prev.ballX), fixedToFloat(state.ballX), alpha));
+        ball.y = (int)std::lround(between(fixedToFloat(prev.ballY), fixedToFloat(state.ballY), alpha));
+        player1.x = (int)std::lround(fixedToFloat(state.paddleX[0]));
+        player1.y = (int)std::lround(between(fixedToFloat(prev.paddleY[0]), fixedToFloat(state.paddleY[0]), alpha));
+        player2.x = (int)std::lround(fixedToFloat(state.paddleX[1]));
+        player2.y = (int)std::lround(between(fixedToFloat(prev.paddleY[1]), fixedToFloat(state.paddleY[1]), alpha));
+        return;
+    }
+
+    // Draw the predicted paddle with the remaining correction blended in
+    int localPlayer = game_data.connectionID;
+    if ((localPlayer == 1 || localPlayer == 2) && predictor.isInitialised()) {
+        SDL_Rect& paddle = localPlayer == 1 ? player1 : player2;
+        paddle.y = (int)std::lround(predictor.getRenderY(alpha));
+    }
+
+    if (game_data.hasBallVelocity) {
+        ball.x = (int)std::lround(between(prevBallX, fixedToFloat(ballSim.state.ballX), alpha) + ballErrorX);
+        ball.y = (int)std::lround(between(prevBallY, fixedToFloat(ballSim.state.ballY), alpha) + ballErrorY);
+    }
+}
+
+// Held keys need ticks to send their input and a running rollback match needs ticks to advance;
+// otherwise only new input or server data can change anything
+bool GameSession::isIdle() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return !game_data.moveUp && !game_data.moveDown && !rollback.isStarted() && !game_data.hasServerUpdate;
+}
+
+void GameSession::setTickRate(int ticksPerSecond) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    tickMs = 1000.0 / ticksPerSecond;
+    inputTiming = InputTiming(tickMs);
+    predictor.setTickRate(ticksPerSecond);
+    ballSim.setTickRate(ticksPerSecond);
+    rollback.setTickRate(ticksPerSecond);
+}
+
+double GameSession::getTickMs() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return rollbackMode ? tickMs : inputTiming.getTickMs();
+}
+
+double GameSession::getRtt() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return clock.getSmoothedRtt();
+}
+
+double GameSession::getServerTick() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return clock.estimateServerTick(nowMs());
+}
+
+double GameSession::getInputMargin() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return inputTiming.getSmoothedMargin();
+}
+
+double GameSession::getTickAdjustment() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return inputTiming.getAdjustment();
+}
+
+double GameSession::getSnapshotAge() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return snapshots.getMeanTransit();
+}
+
+int GameSession::getDesyncMismatches() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return desync.getMismatches();
+}
+
+RollbackStats GameSession::getRollbackStats() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return rollback.getStats();
+}
+
+GameData GameSession::getGameData() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return game_data;
+}
+
+int GameSession::getSnapshotsReceived() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return snapshotsReceived;
+}
+
+int GameSession::getEffectsPlayed() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return effectsPlayed;
+}
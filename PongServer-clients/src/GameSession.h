@@ -0,0 +1,181 @@
+#ifndef __GAME_SESSION_H__
+#define __GAME_SESSION_H__
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include "SDL.h"
+#include "NetClient.h"
+#include "SnapshotBuffer.h"
+#include "PaddlePredictor.h"
+#include "PongSim.h"
+#include "RollbackSession.h"
+#include "DesyncDetector.h"
+#include "ClockSync.h"
+#include "InputTiming.h"
+#include "StartupTimeline.h"
+
+// GameData: the game state as the client knows it, from the server's messages and local input
+struct GameData {
+    float player1Y = 0;  // Y position of player 1
+    float player2Y = 0;  // Y position of player 2
+    float ballX = 0;     // X position of the ball
+    float ballY = 0;     // Y position of the ball
+    float player1X = 0;  // X position of player 1
+    float player2X = 0;  // X position of player 2
+    float ballVX = 0;    // Ball velocity (px/s)
+    float ballVY = 0;
+    bool hasBallVelocity = false;  // The server sends the ball's velocity, so it can be predicted
+
+    bool moveDown = false;   // Flag to move player 1 down
+    bool moveUp = false;     // Flag to move player 1 up
+    int lastSentButtons = 0; // Buttons in the last INPUT sent to the server
+    Uint32 inputAck = 0;     // Last input the server applied to our paddle
+    double inputMarginMs = 0;  // How early (+) or late (-) our latest acknowledged input reached the server's game loop
+    bool hasInputMargin = false;
+    double serverTimeMs = 0; // Server time the latest snapshot was taken at
+    bool hasServerTime = false;  // Snapshots carry the server's tick and time
+    bool hasServerUpdate = false;  // A snapshot arrived since the last reconciliation
+    int playerID = -1;       // Player slot assigned in the handshake (0 = spectator)
+    int connectionID = -1;   // Player slot the server reports in GAME_DATA
+    int player1Score = 0;    // Player 1's score
+    int player2Score = 0;    // Player 2's score
+};
+
+// GameSession class: one client's game state, prediction and network communication, without
+// any window, renderer or audio device. MyGame draws and plays it; the headless client runs
+// many of them in one process. on_receive and takeMessages run on the network thread;
+// everything else runs on the thread that calls update() and tick()
+class GameSession : public SessionHandler {
+protected:
+    // Guards game_data, the player and ball rectangles and the outgoing message queue
+    std::mutex stateMutex;
+
+    // Player and ball positions (rectangles used for drawing)
+    SDL_Rect player1 = { 200, 0, 20, 60 };
+    SDL_Rect player2 = { 580, 0, 20, 60 };
+    SDL_Rect ball = { 390, 0, 20, 20 };
+
+    // Game data instance: Holds all the information about the game state
+    GameData game_data;
+
+    void updateRects(float alpha);  // Place the locally simulated objects between their last two ticks
+
+    // Called with stateMutex held for each game event whose effect is due: the PongEvent bit
+    // and when the event happened or reached us (nowMs())
+    virtual void onEffect(int, double) {}
+
+private:
+    // Recent server snapshots, interpolated for drawing
+    SnapshotBuffer snapshots;
+
+    // Estimate of the server's clock from PING/PONG exchanges
+    ClockSync clock;
+    double lastLatencyLog = 0;  // nowMs() of the last latency line
+
+    // Local paddle prediction, advanced one tick() at a time by the main loop's fixed timestep
+    PaddlePredictor predictor;
+    double tickMs;                // Nominal simulation tick length (ms)
+    double lastUpdateTime = -1;   // nowMs() at the previous update()
+    InputTiming inputTiming;      // Stretches or shrinks the tick so inputs arrive just in time
+    Uint32 lastTimedAck = 0;      // Latest ack whose timing has been fed to inputTiming
+
+    // Ball prediction: the ball runs ahead of the snapshots in a local simulation
+    PongSim ballSim;
+    float ballErrorX = 0;         // Visual correction still being blended out
+    float ballErrorY = 0;
+    float prevBallX = 0;          // Predicted ball before the latest tick, for drawing between ticks
+    float prevBallY = 0;
+    int ballCorrections = 0;      // Snapshots that disagreed with the prediction
+    double lastEffectTime[EVENT_COUNT] = {};  // When each event's effect last played (ms)
+    double lastScoreSoundTime = -1e9;         // When a score sound last played (ms)
+    int soundedScores[2] = { -1, -1 };        // Scores the score sound has played up to (-1 = none seen yet)
+    float snapshotBallVX = 0;                 // Ball velocity in the previous snapshot, for bounce sounds
+    float snapshotBallVY = 0;
+    int snapshotScores[2] = { -1, -1 };       // Scores in the previous snapshot, to tell a point from a bounce
+    int snapshotsReceived = 0;    // GAME_DATA messages taken in
+    int effectsPlayed = 0;        // Effects passed to onEffect()
+
+    void predictBall();  // Advance the predicted ball one tick
+    void correctBall();  // Rebase the predicted ball on the latest snapshot
+    void playEffects(int events, double eventTime);  // onEffect() for PongEvent bits, once per event
+
+    // Rollback mode: both clients simulate the match and only exchange inputs
+    RollbackSession rollback;
+    bool rollbackJoined = false;  // ROLLBACK_JOIN sent to the server
+    double lastRollbackLog = 0;   // nowMs() of the last stats line
+    DesyncDetector desync;        // Compares our simulation with the other player's
+    Sint32 lastHashedTick = -1;   // Latest final tick folded into the desync hash
+    PongState prevRollbackState;  // Rollback state before the latest tick, for drawing between ticks
+
+    void updateRollback();        // update() when the match runs in rollback mode
+    bool tickRollback();          // tick() when the match runs in rollback mode
+
+    // Messages to be sent to the server
+    std::vector<std::string> messages;
+    std::function<void()> sendNotifier;  // Wakes the network thread's send loop (stateMutex)
+    void queueMessage(std::string message);  // Queue and wake the send loop (stateMutex held)
+
+    std::atomic<bool> snapshotEventQueued{ false };  // A wake-up event is already in the SDL queue
+    void publishSnapshotEvent();  // Wake the main loop from the network thread
+
+public:
+    double predictionLeadMs = 50;    // How far ahead of the newest snapshot the ball is predicted before the clock is synced
+    float ballTolerance = 2;         // Prediction errors up to this are not counted as corrections
+    float ballSnapDistance = 100;    // Larger corrections (recentring) are applied immediately
+    float ballErrorHalfLifeMs = 50;  // Time for half of a ball correction to be blended out
+
+    int getBallCorrections() const { return ballCorrections; }
+
+    StartupTimeline startup;  // Time-to-first-frame breakdown, marked from every thread
+
+    double latencyLogIntervalMs = 10000;  // How often RTT, clock offset and delays are printed (0 = never)
+
+    double getRtt();            // Smoothed round-trip time to the server (ms)
+    double getServerTick();     // Estimate of the tick the server is on now
+    double getSnapshotAge();    // How old the newest snapshot is on arrival (ms)
+    double getInputMargin();    // Smoothed margin our inputs reach the server with (ms)
+    double getTickAdjustment(); // Relative change to the local tick length (+ = slower)
+
+    GameSession();
+    virtual ~GameSession() {}
+
+    Uint32 snapshotEventType = 0;  // SDL user event posted when server data arrives (0 = not registered)
+    void onSnapshotEvent() { snapshotEventQueued = false; }  // The main loop took the event
+    bool isIdle();  // Nothing moves until input or server data arrives, so the loop may block
+
+    void setTickRate(int ticksPerSecond);  // Simulation rate; must match the server's for prediction to tick with it
+    double getTickMs();  // Length of the next simulation tick (ms), including input timing corrections
+
+    bool rollbackMode = false;     // Ask the server for a rollback match instead of snapshots
+    int inputDelay = 2;            // Rollback: ticks of local input delay (the server uses the larger of both players')
+    int rollbackWindow = 8;        // Rollback: most ticks simulated ahead of the remote player's input
+    double rollbackLogIntervalMs = 10000;  // Rollback: how often the stats are printed (0 = never)
+
+    std::string desyncReportPrefix = "desync";  // Rollback: first desync is written to <prefix>_tick<N>.txt
+
+    RollbackStats getRollbackStats();  // Snapshot of the rollback counters
+    int getDesyncMismatches();         // Rollback: sync points that differed from the other player's
+
+    GameData getGameData();      // Copy of the current game state
+    int getSnapshotsReceived();  // GAME_DATA messages taken in since the start
+    int getEffectsPlayed();      // Hit and score effects triggered since the start
+
+    // Method declarations
+    void playerMovement();  // Predicts one tick of local paddle movement and queues the input
+    void on_receive(std::string message, std::vector<std::string>& args) override;  // Processes incoming messages
+    bool takeMessages(std::vector<std::string>& outgoing) override;  // Hands queued messages to the network thread
+    void setSendNotifier(std::function<void()> notify) override;
+    void on_session(const SessionInfo& session) override;  // Takes the player slot and tick rate from the handshake
+    void send(std::string message);  // Sends messages to the server
+    void input(SDL_Event& event);  // Handles input events (keyboard presses)
+    void update();  // Once per frame: takes in server data (positions, scores, etc.)
+    bool tick();  // One fixed simulation step; false if the simulation cannot advance yet
+    void checkAndPlayScoreSound(double eventTime);  // Plays the score sound for a score the client has not sounded yet
+    void checkAndPlayBallHitSound(double eventTime);  // Plays hit sounds for bounces seen in the snapshots' ball velocity
+    void checkBallPaddleCollision();  // Checks if the ball collides with a paddle
+    void checkBallWallCollision();  // Checks if the ball collides with the wall
+};
+
+#endif  // __GAME_SESSION_H__
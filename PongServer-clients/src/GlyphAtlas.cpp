@@ -0,0 +1,108 @@
+#include "GlyphAtlas.h"
+#include <iostream>
+
+bool GlyphAtlas::build(SDL_Renderer* renderer, TTF_Font* atlasFont, SDL_Color colour) {
+    destroy();
+    font = atlasFont;
+    if (colour.a == 0) {
+        colour.a = SDL_ALPHA_OPAQUE;  // The glyphs are blitted into an RGBA surface, where alpha 0 would hide them
+    }
+    lineHeight = TTF_FontHeight(font);
+
+    // Render each character on its own (baseline-aligned, font-height tall) and lay them out in one row
+    const int count = LAST_CHAR - FIRST_CHAR + 1;
+    SDL_Surface* images[count] = {};
+    int atlasWidth = 0;
+    for (int i = 0; i < count; i++) {
+        Uint16 ch = (Uint16)(FIRST_CHAR + i);
+        Glyph& glyph = glyphs[i];
+        int minx, maxx, miny, maxy;
+        if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &glyph.advance) != 0) {
+            continue;  // Not in the font; drawn as a gap
+        }
+        glyph.originX = minx < 0 ? -minx : 0;
+
+        char text[2] = { (char)ch, '\0' };
+        images[i] = ch == ' ' ? nullptr : TTF_RenderText_Solid(font, text, colour);
+        if (images[i]) {
+            glyph.source = { atlasWidth, 0, images[i]->w, images[i]->h };
+            atlasWidth += images[i]->w + PADDING;
+        }
+    }
+
+    SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth > 0 ? atlasWidth : 1, lineHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlas) {
+        std::cerr << "Failed to create glyph atlas surface: " << SDL_GetError() << std::endl;
+    }
+    for (int i = 0; i < count; i++) {
+        if (images[i]) {
+            if (atlas) {
+                SDL_BlitSurface(images[i], nullptr, atlas, &glyphs[i].source);
+            }
+            SDL_FreeSurface(images[i]);
+        }
+    }
+    if (!atlas) {
+        return false;
+    }
+
+    texture = SDL_CreateTextureFromSurface(renderer, atlas);
+    SDL_FreeSurface(atlas);
+    if (!texture) {
+        std::cerr << "Failed to create glyph atlas texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void GlyphAtlas::destroy() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+}
+
+bool GlyphAtlas::covers(const std::string& text) const {
+    for (char c : text) {
+        if (c < FIRST_CHAR || c > LAST_CHAR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void GlyphAtlas::measure(const std::string& text, int& w, int& h) const {
+    int pen = 0;
+    int right = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        const Glyph& glyph = glyphs[text[i] - FIRST_CHAR];
+        if (i > 0) {
+            pen += TTF_GetFontKerningSizeGlyphs(font, (Uint16)text[i - 1], (Uint16)text[i]);
+        }
+        int glyphRight = pen - glyph.originX + glyph.source.w;
+        right = glyphRight > right ? glyphRight : right;
+        pen += glyph.advance;
+    }
+    w = pen > right ? pen : right;
+    h = lineHeight;
+}
+
+void GlyphAtlas::draw(SDL_Renderer* renderer, const std::string& text, SDL_Rect& rect) const {
+    measure(text, rect.w, rect.h);
+    if (!texture) {
+        return;
+    }
+
+    int pen = rect.x;
+    for (size_t i = 0; i < text.size(); i++) {
+        const Glyph& glyph = glyphs[text[i] - FIRST_CHAR];
+        if (i > 0) {
+            pen += TTF_GetFontKerningSizeGlyphs(font, (Uint16)text[i - 1], (Uint16)text[i]);
+        }
+        if (glyph.source.w > 0) {
+            SDL_Rect target = { pen - glyph.originX, rect.y, glyph.source.w, glyph.source.h };
+            SDL_RenderCopy(renderer, texture, &glyph.source, &target);
+        }
+        pen += glyph.advance;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef __GLYPH_ATLAS_H__
+#define __GLYPH_ATLAS_H__
+
+#include <string>
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+// GlyphAtlas: every printable ASCII character of one font and colour, pre-rendered once into a
+// single texture. Text made of those characters is drawn as one SDL_RenderCopy per glyph from
+// sub-rects of the atlas, laid out with the font's advances and kerning, so drawing text never
+// creates a surface or texture.
+class GlyphAtlas {
+private:
+    static const int FIRST_CHAR = 32;   // ' '
+    static const int LAST_CHAR = 126;   // '~'
+    static const int PADDING = 1;       // Gap between glyphs so filtering never bleeds between them
+
+    struct Glyph {
+        SDL_Rect source = { 0, 0, 0, 0 };  // Where the glyph is in the atlas
+        int originX = 0;   // Pen position within the glyph's image
+        int advance = 0;   // Pen movement after the glyph
+    };
+
+    SDL_Texture* texture = nullptr;
+    TTF_Font* font = nullptr;
+    Glyph glyphs[LAST_CHAR - FIRST_CHAR + 1];
+    int lineHeight = 0;
+
+public:
+    ~GlyphAtlas() { destroy(); }
+
+    bool build(SDL_Renderer* renderer, TTF_Font* font, SDL_Color colour);  // Render every glyph into the atlas
+    void destroy();
+
+    bool isBuilt() const { return texture != nullptr; }
+    bool covers(const std::string& text) const;  // True if every character of `text` is in the atlas
+    void measure(const std::string& text, int& w, int& h) const;
+    void draw(SDL_Renderer* renderer, const std::string& text, SDL_Rect& rect) const;  // Sets rect.w and rect.h like renderText
+};
+
+#endif  // __GLYPH_ATLAS_H__
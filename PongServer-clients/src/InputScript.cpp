@@ -0,0 +1,84 @@
+#include "InputScript.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+bool InputScript::parse(const std::string& script) {
+    steps.clear();
+    lengthMs = 0;
+
+    size_t start = 0;
+    while (start < script.length()) {
+        size_t end = script.find(',', start);
+        if (end == std::string::npos) {
+            end = script.length();
+        }
+        std::string step = script.substr(start, end - start);
+        start = end + 1;
+
+        size_t colon = step.find(':');
+        double durationMs = colon == std::string::npos ? 0 : atof(step.c_str() + colon + 1);
+        if (colon == std::string::npos || colon == 0 || durationMs <= 0) {
+            std::cerr << "Bad input script step \"" << step << "\" (expected <W|S|WS|->:<ms>)" << std::endl;
+            steps.clear();
+            lengthMs = 0;
+            return false;
+        }
+
+        Step parsed = { 0, durationMs };
+        for (size_t i = 0; i < colon; i++) {
+            char key = (char)toupper(step[i]);
+            if (key == 'W') {
+                parsed.buttons |= PaddleRules::UP;
+            }
+            else if (key == 'S') {
+                parsed.buttons |= PaddleRules::DOWN;
+            }
+            else if (key != '-') {
+                std::cerr << "Unknown key '" << step[i] << "' in input script" << std::endl;
+                steps.clear();
+                lengthMs = 0;
+                return false;
+            }
+        }
+        steps.push_back(parsed);
+        lengthMs += durationMs;
+    }
+    return true;
+}
+
+int InputScript::buttonsAt(double elapsedMs) const {
+    if (steps.empty()) {
+        return 0;
+    }
+    double position = std::fmod(std::max(0.0, elapsedMs), lengthMs);
+    for (const Step& step : steps) {
+        if (position < step.durationMs) {
+            return step.buttons;
+        }
+        position -= step.durationMs;
+    }
+    return steps.back().buttons;
+}
+
+static void sendKey(GameSession& game, SDL_Keycode key, bool down) {
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = down ? SDL_KEYDOWN : SDL_KEYUP;
+    event.key.state = down ? SDL_PRESSED : SDL_RELEASED;
+    event.key.keysym.sym = key;
+    game.input(event);
+}
+
+void pressButtons(GameSession& game, int& held, int buttons) {
+    int changed = held ^ buttons;
+    if (changed & PaddleRules::UP) {
+        sendKey(game, SDLK_w, (buttons & PaddleRules::UP) != 0);
+    }
+    if (changed & PaddleRules::DOWN) {
+        sendKey(game, SDLK_s, (buttons & PaddleRules::DOWN) != 0);
+    }
+    held = buttons;
+}
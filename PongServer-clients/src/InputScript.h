@@ -0,0 +1,31 @@
+#ifndef __INPUT_SCRIPT_H__
+#define __INPUT_SCRIPT_H__
+
+#include <string>
+#include <vector>
+#include "GameSession.h"
+
+// InputScript: a looping sequence of held keys for clients without a keyboard.
+// Written as comma-separated steps "<keys>:<ms>", where keys is W, S, WS or - (nothing held),
+// e.g. "W:500,S:500,-:1000" moves up for half a second, down for half a second, then rests.
+class InputScript {
+private:
+    struct Step {
+        int buttons;      // PaddleRules::Buttons held during the step
+        double durationMs;
+    };
+
+    std::vector<Step> steps;
+    double lengthMs = 0;  // One pass through all steps
+
+public:
+    bool parse(const std::string& script);  // False (and an empty script) if it is malformed
+    bool isEmpty() const { return steps.empty(); }
+    int buttonsAt(double elapsedMs) const;  // Buttons held this far into the script (it repeats)
+};
+
+// Press and release W and S on a session so that `buttons` are held, going through
+// GameSession::input() like keyboard events do. `held` is what is held now and is updated
+void pressButtons(GameSession& game, int& held, int buttons);
+
+#endif  // __INPUT_SCRIPT_H__
@@ -0,0 +1,25 @@
+#include "InputTiming.h"
+#include <algorithm>
+
+InputTiming::InputTiming(double tickMs) {
+    baseTickMs = tickMs;
+}
+
+void InputTiming::onReport(double marginMs) {
+    if (reports == 0) {
+        smoothedMargin = marginMs;
+    }
+    else {
+        smoothedMargin += (marginMs - smoothedMargin) * marginGain;
+    }
+    reports++;
+
+    double error = smoothedMargin - safetyMarginMs;
+    adjustment = std::max(-maxAdjustment, std::min(maxAdjustment, error * adjustmentPerMs));
+}
+
+void InputTiming::reset() {
+    smoothedMargin = 0;
+    adjustment = 0;
+    reports = 0;
+}
@@ -0,0 +1,33 @@
+#ifndef __INPUT_TIMING_H__
+#define __INPUT_TIMING_H__
+
+// InputTiming: keeps the client's inputs arriving just ahead of the server tick that uses them.
+// The server reports, for our latest input, how long it waited before being applied (positive)
+// or how late it was (negative). If inputs land with more margin than safetyMarginMs the local
+// simulation clock is dilated slightly so fewer inputs are produced per second; if they are late
+// it is compressed so they are produced sooner. Adjustment is bounded by maxAdjustment.
+class InputTiming {
+private:
+    double baseTickMs;
+    double smoothedMargin = 0;  // Filtered server-reported margin (ms)
+    double adjustment = 0;      // Current relative change in tick length (+ = slower)
+    int reports = 0;
+
+public:
+    double safetyMarginMs = 8;     // Margin to aim for, covering send jitter
+    double marginGain = 0.1;       // Smoothing of the reported margin
+    double adjustmentPerMs = 0.002;  // Tick length change per ms of margin error (10 ms -> 2%)
+    double maxAdjustment = 0.05;   // Tick length never changes by more than this (5%)
+
+    explicit InputTiming(double tickMs);
+
+    void onReport(double marginMs);  // Margin for a newly acknowledged input
+    void reset();
+
+    double getTickMs() const { return baseTickMs * (1 + adjustment); }  // Length to run the next tick for
+    double getSmoothedMargin() const { return smoothedMargin; }
+    double getAdjustment() const { return adjustment; }
+    int getReportCount() const { return reports; }
+};
+
+#endif  // __INPUT_TIMING_H__
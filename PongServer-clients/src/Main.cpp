@@ -1,5 +1,10 @@
 #include "SDL_net.h"
+#include "BotController.h"
 #include "MyGame.h"
+#include "NetClient.h"
+#include "RenderThread.h"
+#include "Timing.h"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <cstring>
@@ -13,126 +18,142 @@ const Uint16 PORT = 55555;  // Port to connect to
 // Flag to control the main game loop
 bool is_running = true;
 
-// Instance of the game object
-MyGame* game = new MyGame();
+// Longest frame the simulation catches up on; after a longer stall (window drag, breakpoint)
+// the lost time is skipped instead of being simulated in a burst
+const double MAX_FRAME_MS = 250;
 
-// Encryption key for XOR encryption
-const char* KEY = "jnmvk!_!aU5N_3iKdodDD6Z3JzbWSMUiNnnG_b8IGuGcJgQPPajpWR8y6YWqz29n";
+// Longest the loop blocks waiting for events while nothing on screen is changing
+const Uint32 IDLE_WAIT_MS = 100;
 
-// XOR encryption function to decode messages
-// Encrypts/decrypts the text using the provided XOR key
-char* xorCypher(char* text, const char* XOR_KEY) {
-    size_t keyLength = strlen(XOR_KEY);  // Get the length of the XOR key
-    for (size_t i = 0; i < strlen(text); i++) {
-        text[i] ^= XOR_KEY[i % keyLength];  // XOR each character with the key
-    }
-    return text;  // Return the modified text
-}
+// Set when the window needs repainting even though the scene has not changed
+bool force_redraw = true;
 
-// Network thread to handle received data from the server
-// This function is run in a separate thread to receive messages from the server continuously
-static int on_receive(void* socket_ptr) {
-    TCPsocket socket = (TCPsocket)socket_ptr;
-    const int message_length = 1024;
-    char message[message_length];
-    int received;
-
-    do {
-        // Receive data from the server
-        received = SDLNet_TCP_Recv(socket, message, message_length);
-        message[received] = '\0';  // Null-terminate the received message
-        std::cout << "Data Recieved " << message << std::endl;
-
-        // Decrypt the received message
-        char* newMessage = xorCypher(message, KEY);
-        std::cout << "Data Decrypted: " << newMessage << std::endl;
-
-        // Split the decrypted message into command and arguments
-        char* pch = strtok(newMessage, ",");
-        string cmd(pch);  // Get the command
-
-        vector<string> args;
-        while (pch != NULL) {
-            pch = strtok(NULL, ",");
-            if (pch != NULL) {
-                args.push_back(string(pch));  // Add each argument to the vector
-            }
-        }
+// Instance of the game object
+MyGame* game = new MyGame();
 
-        // Pass the command and arguments to the game object
-        game->on_receive(cmd, args);
+// Owns the renderer and draws the frames the main loop builds; paces presents and keeps
+// frame-time and pipeline statistics (F3 prints them)
+RenderThread render_thread(game);
 
-        // Exit the loop if the command is "exit"
-        if (cmd == "exit") {
-            break;
-        }
+// Plays our paddle when started with --bot
+BotController bot;
 
-    } while (received > 0 && is_running);
+// The session's connection, while there is one (F3 prints its link statistics)
+NetClient* network_client = nullptr;
 
-    return 0;  // Return when done
+// Network thread: runs the client session coroutines on an event loop
+static int run_network(void* loop_ptr) {
+    EventLoop* loop = (EventLoop*)loop_ptr;
+    loop->run();  // Returns once the session has ended
+    return 0;
 }
 
-// Network thread to send data to the server
-// Continuously sends data from the game to the server
-static int on_send(void* socket_ptr) {
-    TCPsocket socket = (TCPsocket)socket_ptr;
-
-    while (is_running) {
-        if (game->messages.size() > 0) {
-            string message = "CLIENT_DATA";
+// Handle one SDL event (keyboard, window, quit, snapshot notifications)
+void handleEvent(SDL_Event& event) {
+    if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) && event.key.repeat == 0) {
+        // While a bot plays, W and S are its keys; the keyboard's releases would cancel its presses
+        SDL_Keycode key = event.key.keysym.sym;
+        if (!bot.isActive() || (key != SDLK_w && key != SDLK_s)) {
+            game->input(event);  // Pass the event to the game for processing
+        }
 
-            // Add each message in the queue to the data string
-            for (auto m : game->messages) {
-                message += "," + m;
+        switch (event.key.keysym.sym) {
+        case SDLK_ESCAPE:  // Exit game if Escape is pressed
+            is_running = false;
+            break;
+        case SDLK_F3:  // Print frame pacing and link statistics
+            if (event.type == SDL_KEYDOWN) {
+                render_thread.printStats();
+                game->startup.print();
+                game->sounds.printStats();
+                std::cout << game->getSkippedFrames() << " unchanged frames skipped" << std::endl;
+                if (network_client) {
+                    LinkStats links = network_client->getLinkStats();
+                    std::cout << links.linksLost << " links lost, " << links.reconnects << " reconnects (last took "
+                              << links.lastRecoveryMs << " ms, longest " << links.maxRecoveryMs << " ms)" << std::endl;
+                }
             }
-
-            game->messages.clear();  // Clear the message queue after sending
-
-            cout << "Sending_TCP: " << message << endl;
-            SDLNet_TCP_Send(socket, message.c_str(), message.length());  // Send the message to the server
+            break;
+        default:
+            break;
         }
+    }
 
-        SDL_Delay(1);  // Small delay to prevent blocking
+    if (event.type == SDL_WINDOWEVENT) {
+        force_redraw = true;  // Exposed, resized or restored: repaint the current scene
     }
 
-    return 0;  // Return when done
+    if (game->snapshotEventType != 0 && event.type == game->snapshotEventType) {
+        game->onSnapshotEvent();  // Only wakes the loop; update() picks the snapshot up
+    }
+
+    if (event.type == SDL_QUIT) {
+        is_running = false;  // Exit game if the window is closed
+    }
 }
 
-// Main game loop, handles input, updates, and rendering
-void loop(SDL_Renderer* renderer) {
+// Main game loop, handles input and updates, and hands each frame to the render thread.
+// The simulation runs in fixed ticks from a time accumulator, so its speed does not depend on
+// the frame rate; each frame is drawn the leftover fraction (alpha) of the way into the next tick.
+// Frames that would look the same as the last one are not drawn, and while the game is idle
+// the loop sleeps in SDL_WaitEventTimeout until input, a window event or a new snapshot.
+void loop() {
     SDL_Event event;
+    double previousTime = nowMs();
+    double accumulator = 0;  // Real time not yet simulated (ms)
+    bool idle = false;       // Nothing changed last frame and nothing is in motion
 
     while (is_running) {
-        // Handle all SDL events (keyboard, quit)
-        while (SDL_PollEvent(&event)) {
-            if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) && event.key.repeat == 0) {
-                game->input(event);  // Pass the event to the game for processing
-
-                switch (event.key.keysym.sym) {
-                case SDLK_ESCAPE:  // Exit game if Escape is pressed
-                    is_running = false;
-                    break;
-                default:
-                    break;
-                }
-            }
-
-            if (event.type == SDL_QUIT) {
-                is_running = false;  // Exit game if the window is closed
+        if (idle) {
+            if (SDL_WaitEventTimeout(&event, IDLE_WAIT_MS)) {
+                handleEvent(event);
             }
+            render_thread.idleEnded();
+            previousTime = nowMs();  // Nothing was moving while we slept, so the wait is not simulated
         }
+        double frameStart = nowMs();
 
-        // Clear the screen
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);  // Set the draw color to black
-        SDL_RenderClear(renderer);  // Clear the screen
+        // Handle all SDL events (keyboard, quit)
+        while (SDL_PollEvent(&event)) {
+            handleEvent(event);
+        }
 
-        game->update();  // Update the game state
-        game->render(renderer);  // Render the game scene
+        double now = nowMs();
+        accumulator += std::min(now - previousTime, MAX_FRAME_MS);
+        previousTime = now;
 
-        SDL_RenderPresent(renderer);  // Present the rendered frame
+        bot.update(*game, now);  // Press or release keys like the keyboard would
+        game->update();  // Take in the latest server data
 
-        SDL_Delay(17);  // Delay to achieve ~60fps
+        // Run as many fixed ticks as the elapsed time covers
+        double tickMs = game->getTickMs();
+        while (accumulator >= tickMs) {
+            if (!game->tick()) {
+                accumulator = 0;  // The simulation is waiting (rollback stall); don't bank the time
+                break;
+            }
+            accumulator -= tickMs;
+        }
+        float alpha = (float)(accumulator / tickMs);
+
+        // Skip the frame if it would be identical to what is on screen
+        bool redraw = game->needsRedraw(alpha) || force_redraw;
+        if (redraw) {
+            double buildStart = nowMs();
+            FramePacket packet;
+            game->buildFrame(packet, alpha);  // Describe the game scene between the last two ticks
+            packet.builtAt = nowMs();
+            packet.simulateMs = buildStart - frameStart;
+            packet.buildMs = packet.builtAt - buildStart;
+            render_thread.submit(std::move(packet));
+            force_redraw = false;
+        }
+        idle = !redraw && game->isIdle();
+        if (!idle) {
+            render_thread.waitForNextFrame();  // Keep pace with the display without waiting on a present
+        }
     }
+    render_thread.printStats();
 }
 
 // Initializes the game window and renderer, then starts the game loop
@@ -149,23 +170,31 @@ int run_game() {
         std::cout << "Failed to create window: " << SDL_GetError() << std::endl;
         return -1;  // Window creation failure
     }
+    game->startup.mark("window created");
 
-    // Create an SDL renderer for drawing
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    // Expect VSync at the display's refresh rate
+    SDL_DisplayMode displayMode;
+    FramePacer& pacer = render_thread.pacer;
+    if (pacer.mode == PACE_VSYNC && SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &displayMode) == 0 && displayMode.refresh_rate > 0) {
+        pacer.targetFps = displayMode.refresh_rate;
+    }
 
-    if (nullptr == renderer) {
-        std::cout << "Failed to create renderer: " << SDL_GetError() << std::endl;
+    // Create the renderer on the render thread and load textures and assets for the game there
+    if (!render_thread.start(window)) {
+        render_thread.stop();
+        SDL_DestroyWindow(window);
         return -1;  // Renderer creation failure
     }
 
-    game->loadTextures(renderer);  // Load textures and assets for the game
+    // Snapshots from the network thread wake the loop while it is waiting for events
+    Uint32 snapshotEvent = SDL_RegisterEvents(1);
+    game->snapshotEventType = snapshotEvent == (Uint32)-1 ? 0 : snapshotEvent;
 
-    loop(renderer);  // Start the main game loop
+    loop();  // Start the main game loop
 
-    game->destroyTextures();  // Clean up resources after the game loop ends
+    render_thread.stop();  // Clean up textures and the renderer after the game loop ends
 
     // Clean up SDL resources
-    SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
 
     return 0;
@@ -173,6 +202,8 @@ int run_game() {
 
 // Main function to initialize SDL, SDL_net, and manage network communication
 int main(int argc, char** argv) {
+    game->startup.begin();  // Time-to-first-frame is measured from here
+
     // Initialize SDL
     if (SDL_Init(0) == -1) {
         printf("SDL_Init: %s\n", SDL_GetError());
@@ -184,33 +215,112 @@ int main(int argc, char** argv) {
         printf("SDLNet_Init: %s\n", SDLNet_GetError());
         exit(2);  // SDL_net initialization failure
     }
-
-    IPaddress ip;
-
-    // Resolve host (IP and port) into an IPaddress type
-    if (SDLNet_ResolveHost(&ip, IP_NAME, PORT) == -1) {
-        printf("SDLNet_ResolveHost: %s\n", SDLNet_GetError());
-        exit(3);  // Host resolution failure
+    game->startup.mark("SDL initialised");
+
+    // Pick the transport: TCP to the server by default, or shared memory with
+    // "--shm <name>" when the server runs on the same machine
+    ConnectionConfig config;
+    config.host = IP_NAME;
+    config.port = PORT;
+    config.cipherKey = CIPHER_KEY;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            config.shmName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cipher") == 0) {
+            config.shmCipher = true;  // Keep the XOR stage on the shared-memory path
+        }
+        else if (strcmp(argv[i], "--heartbeat") == 0 && i + 1 < argc) {
+            config.heartbeatIntervalMs = (Uint32)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            config.deadPeerTimeoutMs = (Uint32)atoi(argv[++i]);  // Silence before the server is considered dead
+        }
+        else if (strcmp(argv[i], "--no-reconnect") == 0) {
+            config.reconnect = false;
+        }
+        else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            int rate = atoi(argv[++i]);
+            if (rate > 0) {
+                game->setTickRate(rate);  // Simulation ticks per second, normally the server's rate
+            }
+        }
+        else if (strcmp(argv[i], "--vsync") == 0) {
+            render_thread.pacer.mode = PACE_VSYNC;
+        }
+        else if (strcmp(argv[i], "--uncapped") == 0) {
+            render_thread.pacer.mode = PACE_UNCAPPED;
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            double fps = atof(argv[++i]);
+            if (fps > 0) {
+                render_thread.pacer.mode = PACE_FIXED;  // Cap on performance counter deadlines
+                render_thread.pacer.targetFps = fps;
+            }
+        }
+        else if (strcmp(argv[i], "--no-render-thread") == 0) {
+            render_thread.threaded = false;  // Draw and present on the main thread
+        }
+        else if (strcmp(argv[i], "--render-queue") == 0 && i + 1 < argc) {
+            render_thread.maxQueuedFrames = atoi(argv[++i]);  // Frames allowed to wait for the render thread
+        }
+        else if (strcmp(argv[i], "--assets") == 0 && i + 1 < argc) {
+            game->assetRoot = argv[++i];  // Asset directory; found next to the executable by default
+        }
+        else if (strcmp(argv[i], "--audio-buffer") == 0 && i + 1 < argc) {
+            game->audioBufferSamples = atoi(argv[++i]);  // Mixer buffer in samples (256-512 for low latency)
+        }
+        else if (strcmp(argv[i], "--audio-rate") == 0 && i + 1 < argc) {
+            game->audioFrequency = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--bot") == 0 && i + 1 < argc) {
+            bot.setBehaviour(BotController::create(argv[++i], SDL_GetTicks()));  // perfect, human, idle or toggle
+            if (!bot.isActive()) {
+                std::cerr << "Unknown bot \"" << argv[i] << "\" (perfect, human, idle or toggle)" << std::endl;
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[i], "--rollback") == 0) {
+            game->rollbackMode = true;  // Simulate the match locally and exchange only inputs
+        }
+        else if (strcmp(argv[i], "--input-delay") == 0 && i + 1 < argc) {
+            game->inputDelay = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--rollback-window") == 0 && i + 1 < argc) {
+            game->rollbackWindow = atoi(argv[++i]);
+        }
     }
 
-    // Open a TCP connection to the server
-    TCPsocket socket = SDLNet_TCP_Open(&ip);
-
-    if (!socket) {
-        printf("SDLNet_TCP_Open: %s\n", SDLNet_GetError());
-        exit(4);  // TCP socket open failure
+    // Connect and exchange messages on a separate network thread
+    EventLoop network_loop;
+    NetClient client(network_loop, game, config);
+    network_client = &client;
+    network_loop.spawn(client.run());
+    SDL_Thread* networkThread = SDL_CreateThread(run_network, "NetworkThread", (void*)&network_loop);
+
+    // SDL's video and audio subsystems must be initialised on the main thread, before the audio
+    // device is opened on a loader thread and the window is created on this one
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) == -1) {
+        printf("SDL_InitSubSystem: %s\n", SDL_GetError());
+        exit(1);
+    }
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) == -1) {
+        std::cerr << "SDL audio could not be initialised, playing without sound: " << SDL_GetError() << std::endl;
     }
+    game->startup.mark("video and audio initialised");
 
-    // Start separate threads for receiving and sending data
-    SDL_CreateThread(on_receive, "ConnectionReceiveThread", (void*)socket);
-    SDL_CreateThread(on_send, "ConnectionSendThread", (void*)socket);
+    // Decode assets on worker threads meanwhile; only the texture upload waits for the renderer
+    game->startLoading();
 
     run_game();  // Start the game
 
-    delete game;  // Clean up game instance
+    // Close the connection to the server and wait for the network thread
+    is_running = false;
+    client.stop();
+    SDL_WaitThread(networkThread, nullptr);
+    network_client = nullptr;
 
-    // Close the TCP connection to the server
-    SDLNet_TCP_Close(socket);
+    delete game;  // Clean up game instance
 
     // Shutdown SDL_net and SDL
     SDLNet_Quit();
@@ -1,5 +1,6 @@
 #include "MyGame.h"
 #include "SDL_ttf.h"
+#include "Timing.h"
 #include <iostream>
 #include <SDL_image.h>
 #include <SDL_mixer.h>
@@ -18,107 +19,25 @@ static SDL_Color TEXT_COLOUR = { 255, 255, 255 };  // White text color
 std::string player1ScoreTextString;
 std::string player2ScoreTextString;
 
-// Textures for background, ball, and paddles
-SDL_Texture* backgroundTexture = nullptr;
-SDL_Texture* ballTexture = nullptr;
-
 // -------------------------------------------------
 // MyGame Class Methods
 // -------------------------------------------------
 
-// Helper function to smoothly reconcile the player's position
-void MyGame::reconcilePlayerPosition(SDL_Rect& player, int serverPosition) {
-    const float lerpFactor = 0.1f;  // Adjust for responsiveness (0.1 is smooth)
-    player.y = player.y + (serverPosition - player.y) * lerpFactor;  // Smooth the position
-}
-
-// Handle received game data from server
-void MyGame::on_receive(std::string cmd, std::vector<std::string>& args) {
-    if (cmd == "GAME_DATA") {
-        if (args.size() == 9) {
-            // Update the game state with server data (player positions, scores, etc.)
-            game_data.player1Y = std::stoi(args.at(0));
-            game_data.player2Y = std::stoi(args.at(1));
-            game_data.ballX = std::stoi(args.at(2));
-            game_data.ballY = std::stoi(args.at(3));
-            game_data.player1X = std::stoi(args.at(4));
-            game_data.player2X = std::stoi(args.at(5));
-            game_data.connectionID = std::stoi(args.at(6));
-            game_data.player1Score = std::stoi(args.at(7));
-            game_data.player2Score = std::stoi(args.at(8));
-
-            // After receiving server data, update player positions, ball position, etc.
-            player1.y = game_data.player1Y;
-            player2.y = game_data.player2Y;
-            ball.x = game_data.ballX;
-            ball.y = game_data.ballY;
-            player1.x = game_data.player1X;
-            player2.x = game_data.player2X;
-        }
-    }
-}
-
-// Send messages to the server
-void MyGame::send(std::string message) {
-    messages.push_back(message);  // Add message to queue
-}
-
-// Handle player input (keyboard events)
-void MyGame::input(SDL_Event& event) {
-    switch (event.key.keysym.sym) {
-    case SDLK_w:
-        if (event.type == SDL_KEYDOWN) {
-            send("W_DOWN");
-            game_data.moveUp = true;
-        }
-        else if (event.type == SDL_KEYUP) {
-            send("W_UP");
-            game_data.moveUp = false;
-        }
-        break;
-
-    case SDLK_s:
-        if (event.type == SDL_KEYDOWN) {
-            send("S_DOWN");
-            game_data.moveDown = true;
-        }
-        else if (event.type == SDL_KEYUP) {
-            send("S_UP");
-            game_data.moveDown = false;
-        }
-        break;
-    }
-}
-
-// Check and play score sound when score changes
-void MyGame::checkAndPlayScoreSound() {
-    static int previousPlayer1Score = 0;
-    static int previousPlayer2Score = 0;
-
-    // Check if Player 1's score has increased
-    if (game_data.player1Score > previousPlayer1Score) {
-        Mix_PlayChannel(-1, scoreSound, 0);  // Play score sound
-        previousPlayer1Score = game_data.player1Score;
+// Effects are sounds; the session decides when they are due
+void MyGame::onEffect(int event, double eventTime) {
+    if (event == EVENT_HIT_WALL_LEFT || event == EVENT_HIT_WALL_RIGHT) {
+        sounds.play(scoreSound, eventTime);
     }
-
-    // Check if Player 2's score has increased
-    if (game_data.player2Score > previousPlayer2Score) {
-        Mix_PlayChannel(-1, scoreSound, 0);  // Play score sound
-        previousPlayer2Score = game_data.player2Score;
+    else {
+        sounds.play(ballHitSound, eventTime);
     }
 }
 
 // Update the graphical user interface (GUI)
-void MyGame::updateGUI(SDL_Renderer* renderer) {
-    checkAndPlayScoreSound();
-
-    SDL_Rect textRect = { 20, 8, 0, 0 };
-    std::string screenText = "Player 1: " + std::to_string(game_data.player1Score);
-    renderText(renderer, screenText, textRect);
-
-    textRect = { 624, 8, 0, 0 };
-    screenText = "Player 2: " + std::to_string(game_data.player2Score);
-    renderText(renderer, screenText, textRect);
+// Called from buildFrame() with stateMutex held; the text is drawn by drawFrame()
+void MyGame::updateGUI(FramePacket& packet) {
+    packet.addText("Player 1: " + std::to_string(game_data.player1Score), 20, 8);
+    packet.addText("Player 2: " + std::to_string(game_data.player2Score), 624, 8);
 }
 
 // Helper function to render text to the screen
@@ -128,99 +47,58 @@ void MyGame::renderText(SDL_Renderer* renderer, std::string text, SDL_Rect& rect
         return;
     }
 
-    SDL_Surface* textSurface = TTF_RenderText_Solid(font, text.c_str(), TEXT_COLOUR);
-    if (!textSurface) {
-        std::cerr << "Failed to create text surface: " << TTF_GetError() << std::endl;
-        return;
+    if (glyphs.isBuilt() && glyphs.covers(text)) {
+        glyphs.draw(renderer, text, rect);
     }
-
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    if (!textTexture) {
-        std::cerr << "Failed to create text texture: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(textSurface);
-        return;
-    }
-
-    SDL_QueryTexture(textTexture, NULL, NULL, &rect.w, &rect.h);
-    SDL_RenderCopy(renderer, textTexture, NULL, &rect);
-    SDL_FreeSurface(textSurface);
-    SDL_DestroyTexture(textTexture);
-}
-
-// Handle player movement based on input and server data
-void MyGame::playerMovement() {
-    // Player 1 Movement (based on input and prediction)
-    if (game_data.connectionID == 1) {
-        if (game_data.moveUp) {
-            player1.y += 1 * game_data.PLAYER_SPEED;  // Predictive movement
-        }
-        if (game_data.moveDown) {
-            player1.y -= 1 * game_data.PLAYER_SPEED;  // Predictive movement
-        }
-    }
-
-    // Player 2 Movement (based on input and prediction)
-    if (game_data.connectionID == 2) {
-        if (game_data.moveUp) {
-            player2.y += 1 * game_data.PLAYER_SPEED;  // Predictive movement
-        }
-        if (game_data.moveDown) {
-            player2.y -= 1 * game_data.PLAYER_SPEED;  // Predictive movement
-        }
+    else {
+        textCache.draw(renderer, font, text, rect);
     }
 }
 
 // Load textures and other assets (background, ball, paddles)
 void MyGame::loadTextures(SDL_Renderer* renderer) {
-    // Initialize TTF and font
-    if (TTF_Init() == -1) {
-        std::cerr << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << std::endl;
-    }
-    font = TTF_OpenFont("E:/Dan_Code_Folder/FINAL SERVER PROJECT/CI628/assets/Supercharge-JRgPo.otf", 22);
-    if (!font) {
-        std::cerr << "Failed to load font! TTF Error: " << TTF_GetError() << std::endl;
-        return;
-    }
-
-    if (Mix_Init(MIX_INIT_MP3 | MIX_INIT_OGG) == 0) {
-        std::cerr << "SDL_mixer could not initialize! SDL_mixer Error: " << Mix_GetError() << std::endl;
-    }
-    if (Mix_OpenAudio(22050, MIX_DEFAULT_FORMAT, 2, 4096) < 0) {
-        std::cerr << "SDL_mixer could not open audio! SDL_mixer Error: " << Mix_GetError() << std::endl;
-        return;
-    }
-
-    ballHitSound = Mix_LoadWAV("E:/Dan_Code_Folder/FINAL SERVER PROJECT/CI628/assets/ball_hit.wav");
-    if (!ballHitSound) {
-        std::cerr << "Failed to load ball hit sound: " << Mix_GetError() << std::endl;
-    }
-    else {
-        Mix_VolumeChunk(ballHitSound, MIX_MAX_VOLUME);  // Set to maximum volume
+    startLoading();  // Normally already running, started before the window was created
+    double waitStart = nowMs();
+    assets.wait();
+    double uploadStart = nowMs();
+    startup.mark("waited for decoding", uploadStart - waitStart);
+
+    font = assets.font;
+    if (font) {
+        glyphs.build(renderer, font, TEXT_COLOUR);
+        textCache.colour = TEXT_COLOUR;
+    }
+    ballHitSound = assets.ballHitSound;
+    scoreSound = assets.scoreSound;
+    if (assets.audioOpen) {
+        sounds.attach();  // Measure event-to-audio latency on the opened device
+    }
+
+    // Pack the decoded scene images into one texture
+    for (AssetLoader::Image& image : assets.getImages()) {
+        if (image.surface) {
+            atlas.add(image.name, image.surface);
+            image.surface = nullptr;  // The atlas owns it now
+        }
     }
-
-    scoreSound = Mix_LoadWAV("E:/Dan_Code_Folder/FINAL SERVER PROJECT/CI628/assets/score.wav");
-    if (!scoreSound) {
-        std::cerr << "Failed to load score sound: " << Mix_GetError() << std::endl;
+    if (!atlas.build(renderer)) {
+        std::cerr << "Failed to build the sprite atlas" << std::endl;
     }
-
-    loadTexture(renderer, "E:/Dan_Code_Folder/FINAL SERVER PROJECT/CI628/assets/bg.png", backgroundTexture);
-    loadTexture(renderer, "E:/Dan_Code_Folder/FINAL SERVER PROJECT/CI628/assets/ball.png", ballTexture);
-    loadTexture(renderer, "E:/Dan_Code_Folder/FINAL SERVER PROJECT/CI628/assets/paddle2.png", game_data.leftpaddleTexture);
-    loadTexture(renderer, "E:/Dan_Code_Folder/FINAL SERVER PROJECT/CI628/assets/paddle.png", game_data.rightpaddleTexture);
+    backgroundSprite = atlas.find("bg");
+    ballSprite = atlas.find("ball");
+    leftpaddleSprite = atlas.find("paddle2");
+    rightpaddleSprite = atlas.find("paddle");
+    startup.mark("textures uploaded", nowMs() - uploadStart);
 }
 
-// Helper function to load textures
-void MyGame::loadTexture(SDL_Renderer* renderer, const std::string& path, SDL_Texture*& texture) {
-    SDL_Surface* surface = IMG_Load(path.c_str());
-    if (!surface) {
-        std::cerr << "Failed to load image: " << IMG_GetError() << std::endl;
-        return;
-    }
-    texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!texture) {
-        std::cerr << "Failed to create texture: " << SDL_GetError() << std::endl;
+// Start decoding images, sounds and the font on worker threads
+void MyGame::startLoading() {
+    if (!assetRoot.empty() && assetRoot.back() != '/' && assetRoot.back() != '\\') {
+        assetRoot += '/';
     }
+    assets.audioFrequency = audioFrequency;
+    assets.audioChunkSize = audioBufferSamples;
+    assets.start(assetRoot, &startup);
 }
 
 // -------------------------------------------------
@@ -228,22 +106,45 @@ void MyGame::loadTexture(SDL_Renderer* renderer, const std::string& path, SDL_Te
 // -------------------------------------------------
 
 // Render game objects and update GUI
-void MyGame::render(SDL_Renderer* renderer) {
-    if (backgroundTexture) {
-        SDL_Rect backgroundRect = { 0, 0, 800, 600 };
-        SDL_RenderCopy(renderer, backgroundTexture, nullptr, &backgroundRect);
-    }
-    if (game_data.leftpaddleTexture) {
-        SDL_RenderCopy(renderer, game_data.leftpaddleTexture, nullptr, &player1);
-    }
-    if (game_data.rightpaddleTexture) {
-        SDL_RenderCopy(renderer, game_data.rightpaddleTexture, nullptr, &player2);
-    }
-    if (ballTexture) {
-        SDL_RenderCopy(renderer, ballTexture, nullptr, &ball);
+void MyGame::render(SDL_Renderer* renderer, float alpha) {
+    FramePacket packet;
+    buildFrame(packet, alpha);
+    drawFrame(renderer, packet);
+}
+
+// Snapshot what is on screen this frame into a packet the renderer can draw on its own
+void MyGame::buildFrame(FramePacket& packet, float alpha) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    updateRects(alpha);
+    drawnPlayer1 = player1;
+    drawnPlayer2 = player2;
+    drawnBall = ball;
+    drawnScores[0] = game_data.player1Score;
+    drawnScores[1] = game_data.player2Score;
+
+    // The background goes underneath; with every sprite in the atlas the scene is one run
+    SDL_Rect backgroundRect = { 0, 0, 800, 600 };
+    packet.addSprite(backgroundSprite, backgroundRect, 0);
+    packet.addSprite(leftpaddleSprite, player1, 1);
+    packet.addSprite(rightpaddleSprite, player2, 1);
+    packet.addSprite(ballSprite, ball, 1);
+    updateGUI(packet);  // Update GUI elements (scores)
+}
+
+// Draw a frame packet. Only the rendering thread calls this, and it reads nothing but the
+// packet and the render resources, so it needs no lock
+void MyGame::drawFrame(SDL_Renderer* renderer, const FramePacket& packet) {
+    batch.begin();
+    for (const FramePacket::SpriteItem& item : packet.sprites) {
+        batch.add(item.sprite, item.target, item.layer);
     }
+    batch.flush(renderer);
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    updateGUI(renderer);  // Update GUI elements (scores)
+    for (const FramePacket::TextItem& item : packet.texts) {
+        SDL_Rect textRect = item.rect;
+        renderText(renderer, item.text, textRect);
+    }
+    endTextFrame();
 }
 
 // Clean up textures and audio resources
@@ -256,27 +157,36 @@ void MyGame::cleanUp() {
     TTF_CloseFont(font);
     TTF_Quit();
 
-    SDL_DestroyTexture(game_data.leftpaddleTexture);
-    SDL_DestroyTexture(game_data.rightpaddleTexture);
-    SDL_DestroyTexture(ballTexture);
-    SDL_DestroyTexture(backgroundTexture);
+    atlas.destroy();
 }
 
-// Update the game state based on server data and player input
-void MyGame::update() {
-    if (abs(player1.y - game_data.player1Y) > 5) {
-        player1.y += (game_data.player1Y - player1.y) * 0.3;
-    }
-    if (abs(player2.y - game_data.player2Y) > 5) {
-        player2.y += (game_data.player2Y - player2.y) * 0.3;
+static bool sameRect(const SDL_Rect& a, const SDL_Rect& b) {
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+bool MyGame::needsRedraw(float alpha) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    updateRects(alpha);
+    bool changed = !sameRect(player1, drawnPlayer1) || !sameRect(player2, drawnPlayer2) || !sameRect(ball, drawnBall)
+        || game_data.player1Score != drawnScores[0] || game_data.player2Score != drawnScores[1];
+    if (!changed) {
+        skippedFrames++;
     }
-    playerMovement();  // Handle movement logic
+    return changed;
+}
+
+int MyGame::getSkippedFrames() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return skippedFrames;
+}
+
+Sprite MyGame::getSprite(const std::string& name) {
+    return atlas.find(name);
 }
 
-// Destroy and release textures
+// Destroy and release textures (before the renderer that owns them)
 void MyGame::destroyTextures() {
-    SDL_DestroyTexture(backgroundTexture);
-    SDL_DestroyTexture(game_data.leftpaddleTexture);
-    SDL_DestroyTexture(game_data.rightpaddleTexture);
-    SDL_DestroyTexture(ballTexture);
+    glyphs.destroy();
+    textCache.clear();
+    atlas.destroy();
 }
@@ -6,66 +6,66 @@
 #include <string>
 #include "SDL.h"
 #include "SDL_image.h"
+#include "GameSession.h"
+#include "GlyphAtlas.h"
+#include "TextCache.h"
+#include "SpriteAtlas.h"
+#include "SpriteBatch.h"
+#include "FramePacket.h"
+#include "AssetLoader.h"
+#include "SoundPlayer.h"
 
-// MyGame class: handles the game state, player movements, rendering, and network communication
-class MyGame {
+// MyGame class: draws a game session and plays its sounds
+// on_receive and takeMessages run on the network thread; loadTextures, drawFrame and destroyTextures
+// run on the render thread; everything else runs on the main thread
+class MyGame : public GameSession {
 private:
-    // Player and ball positions (rectangles used for drawing)
-    SDL_Rect player1 = { 200, 0, 20, 60 };
-    SDL_Rect player2 = { 580, 0, 20, 60 };
-    SDL_Rect ball = { 390, 0, 20, 20 };
+    Sprite leftpaddleSprite;   // Atlas region for player 1's paddle
+    Sprite rightpaddleSprite;  // Atlas region for player 2's paddle
+    Sprite ballSprite;         // Atlas region for the ball
+    Sprite backgroundSprite;   // Atlas region for the background
 
-    // Game data structure that stores the game state and assets
-    struct GameData {
-        int player1Y = 0;  // Y position of player 1
-        int player2Y = 0;  // Y position of player 2
-        int ballX = 0;     // X position of the ball
-        int ballY = 0;     // Y position of the ball
-        int player1X = 0;  // X position of player 1
-        int player2X = 0;  // X position of player 2
+    // Text drawing without per-frame uploads: ASCII text comes from the glyph atlas, anything
+    // else from textures cached until the string changes
+    GlyphAtlas glyphs;
+    TextCache textCache;
 
-        const double PLAYER_SPEED = 15;  // Speed of player movement
-        bool moveDown = false;   // Flag to move player 1 down
-        bool moveUp = false;     // Flag to move player 1 up
-        int playerID = -1;       // Player's unique ID
-        int connectionID = -1;   // Connection ID for the network
-        int player1Score = 0;    // Player 1's score
-        int player2Score = 0;    // Player 2's score
+    // All scene images packed into one texture and drawn through one batch
+    SpriteAtlas atlas;
+    SpriteBatch batch;
+    AssetLoader assets;  // Decodes images, sounds and the font off the render thread
 
-        SDL_Texture* leftpaddleTexture = nullptr;  // Texture for player 1's paddle
-        SDL_Texture* rightpaddleTexture = nullptr; // Texture for player 2's paddle
-        SDL_Texture* ballTexture = nullptr;        // Texture for the ball
-        SDL_Texture* backgroundTexture = nullptr;  // Texture for the background
-    };
+    // What the last rendered frame showed, so unchanged frames can be skipped
+    SDL_Rect drawnPlayer1 = { 0, 0, 0, 0 };
+    SDL_Rect drawnPlayer2 = { 0, 0, 0, 0 };
+    SDL_Rect drawnBall = { 0, 0, 0, 0 };
+    int drawnScores[2] = { -1, -1 };
+    int skippedFrames = 0;  // Frames not drawn because nothing had changed
 
-    // Game data instance: Holds all the information about the game state
-    GameData game_data;
+protected:
+    void onEffect(int event, double eventTime) override;  // Plays the event's sound
 
 public:
-    // Messages to be sent to the server
-    std::vector<std::string> messages;
+    std::string assetRoot;  // Directory the assets are loaded from (empty = AssetLoader::findRoot())
+    SoundPlayer sounds;       // Plays effects and measures their event-to-audio latency
+    int audioFrequency = 48000;     // Requested mixer rate (Hz); the device's native rate is used if it differs
+    int audioBufferSamples = 512;   // Mixer buffer; 256-512 samples keeps sounds within a few ms of their events
+
+    bool needsRedraw(float alpha);  // True if a frame drawn now would differ from the last one
+    int getSkippedFrames();
 
-    // Method declarations
-    void playerMovement();  // Handles the movement of players
-    std::string xor(const std::string& data, char key);  // Encrypt/decrypt messages with XOR
-    void on_receive(std::string message, std::vector<std::string>& args);  // Processes incoming messages
-    void send(std::string message);  // Sends messages to the server
-    void input(SDL_Event& event);  // Handles input events (keyboard presses)
-    void update();  // Updates game state (positions, scores, etc.)
     void loadTextures(SDL_Renderer* renderer);  // Loads all game textures
-    void loadTexture(SDL_Renderer* renderer, const std::string& path, SDL_Texture*& texture);  // Loads individual textures
-    void updateGUI(SDL_Renderer* renderer);  // Updates the graphical user interface (GUI)
+    void startLoading();  // Starts decoding assets on worker threads; loadTextures waits for them
+    void updateGUI(FramePacket& packet);  // Updates the graphical user interface (GUI) in a frame packet
     void destroyTextures();  // Frees up memory used by textures
-    void render(SDL_Renderer* renderer);  // Renders the game objects to the screen
+    void render(SDL_Renderer* renderer, float alpha = 1);  // Renders the game objects, alpha of the way into the next tick
+    void buildFrame(FramePacket& packet, float alpha);  // Main thread: describe the frame to draw
+    void drawFrame(SDL_Renderer* renderer, const FramePacket& packet);  // Render thread: draw a frame packet
+    Sprite getSprite(const std::string& name);  // Atlas region of a loaded image ("bg", "ball", "paddle", "paddle2")
+    int getDrawCalls() const { return batch.getDrawCalls(); }  // Sprite draw calls in the last drawFrame()
     void renderText(SDL_Renderer* renderer, std::string text, SDL_Rect& rect);  // Renders text to the screen
+    void endTextFrame() { textCache.endFrame(); }  // After the last renderText() of a frame: evicts stale text textures
     void cleanUp();  // Cleans up game resources
-    void checkAndPlayScoreSound();  // Checks score and plays the corresponding sound
-    void checkAndPlayBallHitSound();  // Checks for ball collisions and plays the sound
-    void checkBallPaddleCollision();  // Checks if the ball collides with a paddle
-    void checkBallWallCollision();  // Checks if the ball collides with the wall
-    void reconcilePlayerPosition(SDL_Rect& player, int serverPosition);  // Synchronizes player position with server
-	
-
 };
 
 #endif  // __MY_GAME_H__
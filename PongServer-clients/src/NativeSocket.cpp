@@ -0,0 +1,278 @@
+#include "NativeSocket.h"
+#include <algorithm>
+#include <cstddef>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+typedef WSAPOLLFD PollEntry;
+static const int SEND_FLAGS = 0;
+
+static bool wouldBlock() {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+static bool setNonBlocking(SocketHandle socket) {
+    u_long on = 1;
+    return ioctlsocket((SOCKET)socket, FIONBIO, &on) == 0;
+}
+
+static int pollEntries(PollEntry* entries, size_t count, int timeoutMs) {
+    return WSAPoll(entries, (ULONG)count, timeoutMs);
+}
+
+void socketClose(SocketHandle socket) {
+    if (socket != NO_SOCKET) {
+        closesocket((SOCKET)socket);
+    }
+}
+
+bool raiseSocketLimit(int sockets) {
+    return true;  // WSAPoll has no descriptor limit to raise
+}
+
+// WSAPoll only takes sockets, so the signal is a UDP socket connected to its own address
+WakeSignal::WakeSignal() {
+    SOCKET handle = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (handle == INVALID_SOCKET) {
+        return;
+    }
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int length = sizeof(local);
+    if (::bind(handle, (const sockaddr*)&local, sizeof(local)) != 0 || getsockname(handle, (sockaddr*)&local, &length) != 0 ||
+        ::connect(handle, (const sockaddr*)&local, sizeof(local)) != 0 || !setNonBlocking((SocketHandle)handle)) {
+        closesocket(handle);
+        return;
+    }
+    readEnd = writeEnd = (SocketHandle)handle;
+}
+
+WakeSignal::~WakeSignal() {
+    socketClose(readEnd);
+}
+
+static int writeWake(SocketHandle socket, char byte) {
+    return ::send((SOCKET)socket, &byte, 1, 0);
+}
+
+static int readWake(SocketHandle socket, char* buffer, int length) {
+    return ::recv((SOCKET)socket, buffer, length, 0);
+}
+
+#else  // !_WIN32
+
+typedef pollfd PollEntry;
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;  // A closed peer is reported as an error, not SIGPIPE
+#else
+static const int SEND_FLAGS = 0;  // SDLNet_Init ignores SIGPIPE
+#endif
+
+static bool wouldBlock() {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+static bool setNonBlocking(SocketHandle socket) {
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static int pollEntries(PollEntry* entries, size_t count, int timeoutMs) {
+    return poll(entries, (nfds_t)count, timeoutMs);
+}
+
+void socketClose(SocketHandle socket) {
+    if (socket != NO_SOCKET) {
+        ::close(socket);
+    }
+}
+
+bool raiseSocketLimit(int sockets) {
+    const rlim_t reserve = 64;  // The process's own files, SDL and the shared-memory segment
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return false;
+    }
+    rlim_t wanted = (rlim_t)sockets + reserve;
+    if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < wanted) {
+        limit.rlim_cur = limit.rlim_max == RLIM_INFINITY ? wanted : std::min(wanted, limit.rlim_max);
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    return limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur >= wanted;
+}
+
+WakeSignal::WakeSignal() {
+    int ends[2];
+    if (pipe(ends) != 0) {
+        return;
+    }
+    if (!setNonBlocking(ends[0]) || !setNonBlocking(ends[1])) {
+        ::close(ends[0]);
+        ::close(ends[1]);
+        return;
+    }
+    readEnd = ends[0];
+    writeEnd = ends[1];
+}
+
+WakeSignal::~WakeSignal() {
+    socketClose(readEnd);
+    socketClose(writeEnd);
+}
+
+static int writeWake(SocketHandle socket, char byte) {
+    return (int)::write(socket, &byte, 1);
+}
+
+static int readWake(SocketHandle socket, char* buffer, int length) {
+    return (int)::read(socket, buffer, length);
+}
+
+#endif  // _WIN32
+
+// Disable Nagle's algorithm, as SDL_net does, so small messages go out at once
+static void setNoDelay(SocketHandle socket) {
+    int on = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&on, sizeof(on));
+}
+
+SocketHandle socketConnect(const IPaddress& address) {
+    SocketHandle handle = (SocketHandle)::socket(AF_INET, SOCK_STREAM, 0);
+    if (handle == NO_SOCKET) {
+        return NO_SOCKET;
+    }
+    sockaddr_in peer = {};
+    peer.sin_family = AF_INET;
+    peer.sin_addr.s_addr = address.host;  // Both already in network byte order
+    peer.sin_port = address.port;
+    if (::connect(handle, (const sockaddr*)&peer, sizeof(peer)) != 0 || !setNonBlocking(handle)) {
+        socketClose(handle);
+        return NO_SOCKET;
+    }
+    setNoDelay(handle);
+    return handle;
+}
+
+SocketHandle socketListen(Uint16 port) {
+    SocketHandle handle = (SocketHandle)::socket(AF_INET, SOCK_STREAM, 0);
+    if (handle == NO_SOCKET) {
+        return NO_SOCKET;
+    }
+#ifndef _WIN32
+    int on = 1;
+    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));  // Restart without waiting out TIME_WAIT
+#endif
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+    if (::bind(handle, (const sockaddr*)&local, sizeof(local)) != 0 || ::listen(handle, SOMAXCONN) != 0 ||
+        !setNonBlocking(handle)) {
+        socketClose(handle);
+        return NO_SOCKET;
+    }
+    return handle;
+}
+
+SocketHandle socketAccept(SocketHandle listener) {
+    SocketHandle handle = (SocketHandle)::accept(listener, nullptr, nullptr);
+    if (handle == NO_SOCKET) {
+        return NO_SOCKET;
+    }
+    if (!setNonBlocking(handle)) {
+        socketClose(handle);
+        return NO_SOCKET;
+    }
+    setNoDelay(handle);
+    return handle;
+}
+
+int socketSend(SocketHandle socket, const char* data, int length) {
+    int sent = (int)::send(socket, data, length, SEND_FLAGS);
+    if (sent < 0) {
+        return wouldBlock() ? SOCKET_WOULD_BLOCK : -1;
+    }
+    return sent;
+}
+
+int socketRecv(SocketHandle socket, char* buffer, int maxLength) {
+    int received = (int)::recv(socket, buffer, maxLength, 0);
+    if (received < 0) {
+        return wouldBlock() ? SOCKET_WOULD_BLOCK : -1;
+    }
+    return received;
+}
+
+// -------------------------------------------------
+// SocketPoller
+// -------------------------------------------------
+
+int SocketPoller::add(SocketHandle socket, int events) {
+    short polled = 0;
+    if (events & READ) {
+        polled |= POLLIN;
+    }
+    if (events & WRITE) {
+        polled |= POLLOUT;
+    }
+    entries.push_back({ socket, polled, 0 });
+    return (int)entries.size() - 1;
+}
+
+int SocketPoller::wait(Uint32 timeoutMs) {
+    static_assert(sizeof(Entry) == sizeof(PollEntry) && offsetof(Entry, events) == offsetof(PollEntry, events) &&
+                      offsetof(Entry, revents) == offsetof(PollEntry, revents),
+                  "SocketPoller::Entry must match the platform's poll entry");
+    for (Entry& entry : entries) {
+        entry.revents = 0;
+    }
+    int timeout = timeoutMs > 0x7FFFFFFF ? -1 : (int)timeoutMs;  // FOREVER and anything poll() cannot take
+    int ready = pollEntries(reinterpret_cast<PollEntry*>(entries.data()), entries.size(), timeout);
+    return ready < 0 && wouldBlock() ? 0 : ready;  // Interrupted by a signal: a wait with nothing ready
+}
+
+int SocketPoller::ready(int index) const {
+    short revents = entries[index].revents;
+    int result = 0;
+    if (revents & (POLLIN | POLLERR | POLLHUP | POLLNVAL)) {
+        result |= READ;  // The read reports the error or the end of the stream
+    }
+    if (revents & (POLLOUT | POLLERR | POLLHUP | POLLNVAL)) {
+        result |= WRITE;
+    }
+    return result;
+}
+
+// -------------------------------------------------
+// WakeSignal
+// -------------------------------------------------
+
+void WakeSignal::raise() {
+    if (writeEnd != NO_SOCKET && !raised.exchange(true)) {
+        writeWake(writeEnd, 1);
+    }
+}
+
+void WakeSignal::clear() {
+    char buffer[64];
+    while (readEnd != NO_SOCKET && readWake(readEnd, buffer, sizeof(buffer)) > 0) {
+    }
+    raised.store(false);  // Only once drained: a raise() in between writes nothing, and its cause is checked next
+}
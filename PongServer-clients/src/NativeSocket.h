@@ -0,0 +1,76 @@
+#ifndef __NATIVE_SOCKET_H__
+#define __NATIVE_SOCKET_H__
+
+#include "SDL_net.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Native TCP sockets, for what SDL_net cannot do: wait on any number of sockets (SDLNet_CheckSockets
+// uses select(), which stops at FD_SETSIZE descriptors) and read or write without blocking.
+// SDL_net still starts the socket library (SDLNet_Init) and resolves host names.
+// Every socket is in non-blocking mode from the moment it is returned.
+
+#ifdef _WIN32
+typedef uintptr_t SocketHandle;  // SOCKET
+#else
+typedef int SocketHandle;
+#endif
+
+const SocketHandle NO_SOCKET = (SocketHandle)-1;
+const int SOCKET_WOULD_BLOCK = -2;  // socketSend/socketRecv could not go ahead without waiting
+
+SocketHandle socketConnect(const IPaddress& address);  // Waits for the TCP handshake; NO_SOCKET on failure
+SocketHandle socketListen(Uint16 port);                // On every interface; NO_SOCKET on failure
+SocketHandle socketAccept(SocketHandle listener);      // NO_SOCKET when no connection is waiting
+int socketSend(SocketHandle socket, const char* data, int length);  // Bytes taken, SOCKET_WOULD_BLOCK or -1
+int socketRecv(SocketHandle socket, char* buffer, int maxLength);  // Bytes, 0 on close, SOCKET_WOULD_BLOCK or -1
+void socketClose(SocketHandle socket);
+
+// Lets this process open at least `sockets` more descriptors if the hard limit allows;
+// returns false if it does not
+bool raiseSocketLimit(int sockets);
+
+// SocketPoller: one poll() (WSAPoll on Windows) over a set of sockets, rebuilt for every wait
+class SocketPoller {
+private:
+    struct Entry {  // Laid out like pollfd and WSAPOLLFD, which poll() is handed directly
+        SocketHandle socket;
+        short events;
+        short revents;
+    };
+
+    std::vector<Entry> entries;
+
+public:
+    static const int READ = 1;
+    static const int WRITE = 2;
+    static const Uint32 FOREVER = 0xFFFFFFFF;  // No timeout
+
+    void clear() { entries.clear(); }
+    int add(SocketHandle socket, int events);  // Returns the index to pass to ready()
+    int wait(Uint32 timeoutMs);  // Number of ready sockets, 0 on timeout, -1 on error
+    int ready(int index) const;  // READ and WRITE bits; errors and hang-ups count as READ
+    bool isEmpty() const { return entries.empty(); }
+};
+
+// WakeSignal: lets any thread end a SocketPoller wait on another. The waiting thread polls
+// socket() for READ and clears the signal once it has woken
+class WakeSignal {
+private:
+    SocketHandle readEnd = NO_SOCKET;   // A pipe, or on Windows a loopback UDP socket that sends to itself
+    SocketHandle writeEnd = NO_SOCKET;
+    std::atomic<bool> raised{ false };  // A byte is waiting in readEnd, so raise() need not write another
+
+public:
+    WakeSignal();
+    ~WakeSignal();
+    WakeSignal(const WakeSignal&) = delete;
+    WakeSignal& operator=(const WakeSignal&) = delete;
+
+    SocketHandle socket() const { return readEnd; }  // NO_SOCKET if it could not be created
+    void raise();  // Thread-safe
+    void clear();  // Before checking what the signal was raised for, so no raise is missed
+};
+
+#endif  // __NATIVE_SOCKET_H__
@@ -0,0 +1,295 @@
+#include "NetClient.h"
+#include "ShmTransport.h"
+#include <algorithm>
+#include <iostream>
+
+NetClient::NetClient(EventLoop& loop, SessionHandler* handler, const ConnectionConfig& config)
+    : loop(loop), handler(handler), config(config) {
+    EventLoop* target = &loop;
+    handler->setSendNotifier([target]() { target->wake(); });
+}
+
+NetClient::~NetClient() {
+    handler->setSendNotifier(nullptr);
+    delete channel;
+}
+
+LinkStats NetClient::getLinkStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats;
+}
+
+void NetClient::stop() {
+    stopToken.cancel();
+    linkToken.cancel();
+}
+
+// Open the transport and wrap it in a channel
+Task<bool> NetClient::connect() {
+    const char* key = config.cipherKey.empty() ? nullptr : config.cipherKey.c_str();
+
+    if (!config.shmName.empty()) {
+        // Shared memory delivers whole messages, so framing is skipped and the cipher is optional
+        ShmTransport* transport = ShmTransport::attach(config.shmName.c_str());
+        if (!transport) {
+            co_return false;
+        }
+        channel = new Channel(transport, false, config.shmCipher ? key : nullptr);
+        co_return true;
+    }
+
+    // The connect is synchronous, so this blocks the loop for the duration of the TCP handshake
+    TcpTransport* transport = TcpTransport::connect(config.host.c_str(), config.port);
+    if (!transport) {
+        co_return false;
+    }
+    channel = new Channel(transport, true, key);
+    co_return true;
+}
+
+// Offer our protocol version and capabilities and wait for the server's choice.
+// Messages that arrive before WELCOME are passed on as usual. Returns false if the
+// connection failed; a server that never answers is treated as a pre-handshake server.
+Task<bool> NetClient::handshake() {
+    int offered = CLIENT_CAPABILITIES;
+    if (!channel->hasCipher()) {
+        offered &= ~CAP_CIPHER;
+    }
+    if (config.shmName.empty()) {
+        offered &= ~CAP_SHM_TRANSPORT;
+    }
+
+    // A reconnecting client presents its token to get its slot back
+    std::string hello = "HELLO," + std::to_string(PROTOCOL_VERSION) + "," + std::to_string(offered);
+    if (!session.resumeToken.empty()) {
+        hello += "," + session.resumeToken;
+    }
+    if (!co_await loop.writable(*channel, (int)hello.length(), SEND_TIMEOUT_MS, &linkToken) || !channel->sendMessage(hello)) {
+        co_return false;
+    }
+
+    Uint32 deadline = SDL_GetTicks() + HANDSHAKE_TIMEOUT_MS;
+    char* message;
+    std::string cmd;
+    std::vector<std::string> args;
+    while (true) {
+        Uint32 now = SDL_GetTicks();
+        int remaining = (int)(deadline - now);
+        if (remaining <= 0) {
+            std::cout << "Server did not answer HELLO; continuing without a handshake" << std::endl;
+            co_return true;
+        }
+        if (!co_await loop.readable(*channel, remaining, &linkToken)) {
+            if (linkToken.isCancelled()) {
+                co_return false;
+            }
+            continue;  // Timed out; the deadline check decides
+        }
+
+        int received;
+        while ((received = channel->tryReceiveMessage(message)) >= 0) {
+            splitMessage(message, received, cmd, args);
+            if (cmd == "WELCOME" && args.size() >= 4) {
+                try {
+                    session = SessionInfo();
+                    session.version = std::stoi(args.at(0));
+                    session.playerSlot = std::stoi(args.at(1));
+                    session.tickRate = std::stoi(args.at(2));
+                    session.capabilities = std::stoi(args.at(3));
+                    if (args.size() >= 6) {
+                        session.resumeToken = args.at(4);
+                        session.resumed = args.at(5) == "1";
+                    }
+                    session.negotiated = true;
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "Malformed WELCOME message: " << e.what() << std::endl;
+                    continue;
+                }
+
+                // Take the agreed path from the next message on
+                if (!(session.capabilities & CAP_CIPHER)) {
+                    channel->setCipherKey(nullptr);
+                }
+                std::cout << (session.resumed ? "Resumed" : "Joined") << " as player " << session.playerSlot << " (protocol " << session.version
+                          << ", " << session.tickRate << " Hz, capabilities " << session.capabilities << ")" << std::endl;
+                handler->on_session(session);
+                co_return true;
+            }
+
+            try {
+                handler->on_receive(cmd, args);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Malformed " << cmd << " message: " << e.what() << std::endl;
+            }
+        }
+        if (received == -1 || linkToken.isCancelled()) {
+            co_return false;
+        }
+    }
+}
+
+void NetClient::disconnect() {
+    if (channel) {
+        delete channel;
+        channel = nullptr;
+    }
+}
+
+Task<> NetClient::run() {
+    int attempt = 0;
+
+    while (!stopToken.isCancelled()) {
+        LinkEnd end = LINK_CLOSED;
+        bool established = false;
+        if (co_await connect()) {
+            linkToken.reset();
+            if (stopToken.isCancelled()) {
+                linkToken.cancel();
+            }
+
+            if (!config.handshake || co_await handshake()) {
+                attempt = 0;
+                established = true;
+                bool sendFinished = false;
+                loop.spawn(sendLoop(sendFinished));
+
+                end = co_await receiveLoop();
+
+                // The connection is gone: stop the sender, wait for it, then release the channel
+                linkToken.cancel();
+                co_await loop.until([&sendFinished]() { return sendFinished; });
+            }
+            else {
+                std::cerr << "Connection closed during the handshake" << std::endl;
+            }
+            disconnect();
+        }
+        else {
+            std::cerr << "Failed to connect to " << config.host << ":" << config.port << std::endl;
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.failedAttempts++;
+        }
+
+        // Counted even when there will be no reconnect, so callers see the loss
+        if (established && end != LINK_EXIT && !stopToken.isCancelled()) {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.linksLost++;
+            if (lostAt == 0) {
+                lostAt = SDL_GetTicks();  // Recovery is timed from the first loss
+            }
+        }
+        if (end == LINK_EXIT || stopToken.isCancelled() || !config.reconnect) {
+            break;
+        }
+
+        // Back off exponentially so a server that is down isn't hammered
+        attempt++;
+        if (config.maxReconnectAttempts > 0 && attempt > config.maxReconnectAttempts) {
+            std::cerr << "Giving up after " << config.maxReconnectAttempts << " reconnect attempts" << std::endl;
+            break;
+        }
+        Uint32 delay = config.reconnectInitialMs << std::min(attempt - 1, 16);
+        if (delay > config.reconnectMaxMs || delay < config.reconnectInitialMs) {
+            delay = config.reconnectMaxMs;
+        }
+        std::cout << "Reconnecting in " << delay << " ms (attempt " << attempt << ")" << std::endl;
+        co_await loop.sleep(delay, &stopToken);
+    }
+}
+
+// Receive every message the server sends and hand it to the game
+Task<NetClient::LinkEnd> NetClient::receiveLoop() {
+    char* message;
+    std::string cmd;
+    std::vector<std::string> args;
+    Uint32 timeout = config.deadPeerTimeoutMs > 0 ? config.deadPeerTimeoutMs : EventLoop::FOREVER;
+
+    while (true) {
+        if (!co_await loop.readable(*channel, timeout, &linkToken)) {
+            if (linkToken.isCancelled()) {
+                co_return LINK_CANCELLED;
+            }
+            std::cout << "No message from the server for " << timeout << " ms; dropping the connection" << std::endl;
+            co_return LINK_TIMED_OUT;
+        }
+
+        int received;
+        while ((received = channel->tryReceiveMessage(message)) >= 0) {
+            if (lostAt != 0) {
+                // First message on the new connection: the session has recovered
+                Uint32 recovery = SDL_GetTicks() - lostAt;
+                std::unique_lock<std::mutex> lock(statsMutex);
+                stats.reconnects++;
+                stats.lastRecoveryMs = recovery;
+                stats.maxRecoveryMs = std::max(stats.maxRecoveryMs, recovery);
+                lock.unlock();
+                lostAt = 0;
+                std::cout << "Recovered in " << recovery << " ms" << std::endl;
+            }
+
+            splitMessage(message, received, cmd, args);
+            try {
+                handler->on_receive(cmd, args);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Malformed " << cmd << " message: " << e.what() << std::endl;
+            }
+
+            if (cmd == "exit") {
+                co_return LINK_EXIT;
+            }
+        }
+
+        if (received == -1) {
+            std::cout << "Connection to server closed" << std::endl;
+            co_return LINK_CLOSED;
+        }
+    }
+}
+
+// Send queued game messages to the server as one CLIENT_DATA message per batch. The handler
+// wakes the loop when it queues messages, so nothing is polled while the game is quiet
+Task<> NetClient::sendLoop(bool& finished) {
+    std::vector<std::string> outgoing;
+    auto hasOutgoing = [this, &outgoing]() { return handler->takeMessages(outgoing); };
+
+    Uint32 heartbeat = config.heartbeatIntervalMs > 0 ? config.heartbeatIntervalMs : EventLoop::FOREVER;
+    Uint32 lastSent = SDL_GetTicks();
+
+    while (true) {
+        Uint32 idle = SDL_GetTicks() - lastSent;
+        Uint32 untilHeartbeat = heartbeat == EventLoop::FOREVER ? heartbeat : heartbeat - std::min(idle, heartbeat);
+        Uint32 untilScheduled = handler->msUntilMessages();
+        if (!co_await loop.signalled(hasOutgoing, std::min(untilHeartbeat, untilScheduled), &linkToken)) {
+            if (linkToken.isCancelled()) {
+                break;
+            }
+            if (untilScheduled < untilHeartbeat) {
+                continue;  // Woke for the handler's schedule; takeMessages may still have had nothing
+            }
+            // Nothing to send for a while: send a heartbeat so the server knows we are alive
+            outgoing.push_back("HEARTBEAT");
+        }
+
+        std::string message = "CLIENT_DATA";
+        for (const std::string& m : outgoing) {
+            message += "," + m;
+        }
+        outgoing.clear();
+
+        if (!co_await loop.writable(*channel, (int)message.length(), SEND_TIMEOUT_MS, &linkToken)) {
+            break;
+        }
+        if (!channel->sendMessage(message)) {
+            std::cerr << "Failed to send to server" << std::endl;
+            break;
+        }
+        lastSent = SDL_GetTicks();
+    }
+
+    // A failed send ends the whole connection
+    linkToken.cancel();
+    finished = true;
+}
@@ -0,0 +1,103 @@
+#ifndef __NET_CLIENT_H__
+#define __NET_CLIENT_H__
+
+#include "EventLoop.h"
+#include "Protocol.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ConnectionConfig: where a session connects and which channel stages it uses
+struct ConnectionConfig {
+    std::string host = "localhost";  // Server host name or IP address
+    Uint16 port = 55555;             // Server TCP port
+    std::string shmName;             // Shared-memory segment to attach to instead of TCP (empty = TCP)
+    bool shmCipher = false;          // Keep the XOR stage on the shared-memory path
+    std::string cipherKey;           // XOR key shared with the server
+    bool handshake = true;           // Send HELLO and wait for WELCOME before anything else
+
+    Uint32 heartbeatIntervalMs = 1000;  // Send a HEARTBEAT when nothing else was sent for this long (0 = never)
+    Uint32 deadPeerTimeoutMs = 3000;    // Drop the connection after this long without a message (0 = never)
+    bool reconnect = true;              // Reconnect after the connection is lost
+    Uint32 reconnectInitialMs = 250;    // First reconnect delay; doubles with every failed attempt...
+    Uint32 reconnectMaxMs = 8000;       // ...up to this
+    int maxReconnectAttempts = 0;       // Give up after this many attempts in a row (0 = never)
+};
+
+// SessionInfo: what the handshake agreed on
+struct SessionInfo {
+    bool negotiated = false;  // False for servers that don't answer HELLO
+    int version = 0;          // Protocol version in use
+    int playerSlot = -1;      // 1 or 2, 0 for a spectator, -1 if unknown
+    int tickRate = 60;        // Server simulation ticks per second
+    int capabilities = 0;     // Capability bits both sides agreed on
+    std::string resumeToken;  // Presented on reconnect to get the same slot back
+    bool resumed = false;     // This connection resumed an earlier session
+};
+
+// Reconnection counters
+struct LinkStats {
+    int linksLost = 0;         // Connections that ended unexpectedly
+    int reconnects = 0;        // Sessions resumed or restarted after a loss
+    int failedAttempts = 0;    // Connection attempts that failed
+    Uint32 lastRecoveryMs = 0; // Loss to first message on the new connection, for the last recovery
+    Uint32 maxRecoveryMs = 0;
+};
+
+// SessionHandler: the game side of a network session
+class SessionHandler {
+public:
+    virtual ~SessionHandler() {}
+
+    virtual void on_receive(std::string cmd, std::vector<std::string>& args) = 0;  // Handles one server message
+    virtual bool takeMessages(std::vector<std::string>& messages) = 0;  // Moves queued outgoing messages into `messages`
+    virtual void on_session(const SessionInfo& session) {}  // Called once the handshake has finished
+    // NetClient hands over a function that wakes its send loop (nullptr when it goes away);
+    // call it from any thread after queuing messages for takeMessages
+    virtual void setSendNotifier(std::function<void()> notify) {}
+    // For messages that come due on a schedule instead: ms until takeMessages has more
+    virtual Uint32 msUntilMessages() { return EventLoop::FOREVER; }
+};
+
+// NetClient: one client session, written as coroutines on an EventLoop.
+// Several sessions can share one loop (and one thread).
+class NetClient {
+private:
+    EventLoop& loop;
+    SessionHandler* handler;
+    ConnectionConfig config;
+    Channel* channel = nullptr;  // Open connection, or nullptr
+    CancelToken stopToken;       // Cancelled by stop(): ends the session
+    CancelToken linkToken;       // Cancelled when the current connection ends
+
+    SessionInfo session;
+    LinkStats stats;
+    mutable std::mutex statsMutex;  // The game may read stats while the session runs
+    Uint32 lostAt = 0;  // SDL_GetTicks() when the link was lost, 0 while connected
+
+    // Why a connection ended
+    enum LinkEnd { LINK_CLOSED, LINK_TIMED_OUT, LINK_EXIT, LINK_CANCELLED };
+
+    Task<bool> connect();
+    Task<bool> handshake();
+    Task<LinkEnd> receiveLoop();
+    Task<> sendLoop(bool& finished);
+    void disconnect();
+
+public:
+    static const Uint32 SEND_TIMEOUT_MS = 1000;  // Give up on a connection that cannot take a message for this long
+    static const Uint32 HANDSHAKE_TIMEOUT_MS = 2000;  // Assume an older server if WELCOME takes longer
+
+    NetClient(EventLoop& loop, SessionHandler* handler, const ConnectionConfig& config);
+    ~NetClient();
+
+    // Connect, then exchange messages until the server says exit or stop() is called,
+    // reconnecting with exponential backoff whenever the connection is lost
+    Task<> run();
+    void stop();   // Thread-safe
+
+    const SessionInfo& getSession() const { return session; }
+    LinkStats getLinkStats() const;  // Thread-safe
+};
+
+#endif  // __NET_CLIENT_H__
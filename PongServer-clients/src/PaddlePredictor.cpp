@@ -0,0 +1,63 @@
+#include "PaddlePredictor.h"
+#include <cmath>
+
+Uint32 PaddlePredictor::tick(int buttons) {
+    Uint32 seq = nextSeq++;
+    prevSimY = simY;
+    simY = PaddleRules::step(simY, buttons, stepPx);
+
+    Entry& entry = history[seq % HISTORY_SIZE];
+    entry.seq = seq;
+    entry.buttons = buttons;
+    entry.predictedY = simY;
+    return seq;
+}
+
+void PaddlePredictor::reconcile(Uint32 ackedSeq, float serverY) {
+    if (ackedSeq >= nextSeq || (initialised && ackedSeq < lastAcked)) {
+        return;  // Acknowledges input we never sent, or older than what we already have
+    }
+    bool first = !initialised;
+    initialised = true;
+    lastAcked = ackedSeq;
+
+    float before = simY;
+    simY = serverY;
+
+    if (nextSeq - 1 - ackedSeq >= (Uint32)HISTORY_SIZE) {
+        // Too far behind to replay: accept the server position outright
+        errorOffset = 0;
+        prevSimY = simY;
+        return;
+    }
+
+    for (Uint32 seq = ackedSeq + 1; seq < nextSeq; seq++) {
+        Entry& entry = history[seq % HISTORY_SIZE];
+        simY = PaddleRules::step(simY, entry.buttons, stepPx);
+        entry.predictedY = simY;
+    }
+
+    // Keep the paddle where it was drawn and let the difference fade out; the previous tick's
+    // position moves with the correction so drawing between ticks stays continuous
+    errorOffset = first ? 0 : errorOffset + (before - simY);
+    prevSimY += simY - before;
+    if (first || std::fabs(errorOffset) > snapDistance) {
+        errorOffset = 0;
+        prevSimY = simY;
+    }
+}
+
+void PaddlePredictor::decayError(double elapsedMs) {
+    errorOffset *= (float)std::pow(0.5, elapsedMs / errorHalfLifeMs);
+    if (std::fabs(errorOffset) < 0.05f) {
+        errorOffset = 0;
+    }
+}
+
+void PaddlePredictor::reset(float y) {
+    simY = y;
+    prevSimY = y;
+    errorOffset = 0;
+    lastAcked = nextSeq - 1;
+    initialised = true;
+}
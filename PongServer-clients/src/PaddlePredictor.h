@@ -0,0 +1,75 @@
+#ifndef __PADDLE_PREDICTOR_H__
+#define __PADDLE_PREDICTOR_H__
+
+#include "SDL.h"
+
+// Paddle movement rules mirrored from the server's PlayerCharacterComponent.
+// The server sets a 420 px/s velocity while a key is held; at the 60 Hz tick that is 7 px per tick.
+namespace PaddleRules {
+    const int TICK_RATE = 60;                         // Simulation ticks per second
+    const float SPEED = 420.0f;                       // PlayerCharacterComponent.PLAYER_SPEED (px/s)
+    const float STEP = SPEED / TICK_RATE;             // Movement per tick
+    const float TOP_LIMIT = SPEED / 60;               // moveUp() only moves while y >= this
+    const float BOTTOM_LIMIT = 800 - 25;              // moveDown() only moves while y <= this (the server uses the app width)
+
+    enum Buttons { UP = 1, DOWN = 2 };
+
+    // Advance a paddle one tick of `stepPx` (STEP at TICK_RATE); both keys together stop it,
+    // like releasing both
+    inline float step(float y, int buttons, float stepPx = STEP) {
+        bool up = (buttons & UP) != 0;
+        bool down = (buttons & DOWN) != 0;
+        if (up && !down && y >= TOP_LIMIT) {
+            return y - stepPx;
+        }
+        if (down && !up && y <= BOTTOM_LIMIT) {
+            return y + stepPx;
+        }
+        return y;
+    }
+}
+
+// PaddlePredictor: client-side prediction of the local paddle with reconciliation by replay.
+// Every tick's input is stored with its sequence number and the position it produced.
+// When a snapshot acknowledges input N, the paddle is rewound to the server's position and
+// inputs N+1..latest are replayed with the same rules. The difference between the old and
+// new prediction goes into a visual offset that decays on its own, so corrections are
+// smoothed on screen without ever bending the simulated position.
+class PaddlePredictor {
+private:
+    struct Entry {
+        Uint32 seq = 0;
+        int buttons = 0;
+        float predictedY = 0;
+    };
+
+    static const int HISTORY_SIZE = 256;  // Ticks of unacknowledged input kept (~4 s at 60 Hz)
+
+    Entry history[HISTORY_SIZE];
+    Uint32 nextSeq = 1;       // Sequence number for the next input
+    Uint32 lastAcked = 0;     // Highest input the server has confirmed
+    float simY = 0;           // Predicted simulation position
+    float prevSimY = 0;       // Simulation position before the latest tick, for drawing between ticks
+    float errorOffset = 0;    // Visual correction still being blended out
+    bool initialised = false; // True once a server position has been seen
+    float stepPx = PaddleRules::STEP;  // Movement per tick at the simulation's tick rate
+
+public:
+    float errorHalfLifeMs = 60;  // Time for half of a correction to be blended out
+    float snapDistance = 60;     // Corrections larger than this are applied immediately
+
+    Uint32 tick(int buttons);  // Predict one tick of input; returns the input's sequence number
+    void reconcile(Uint32 ackedSeq, float serverY);  // Rewind to the server state and replay
+    void decayError(double elapsedMs);  // Blend out part of the visual correction
+    void reset(float y);  // Snap to a position and forget all history
+    void setTickRate(int ticksPerSecond) { stepPx = PaddleRules::SPEED / ticksPerSecond; }
+
+    bool isInitialised() const { return initialised; }
+    float getSimY() const { return simY; }
+    float getRenderY() const { return simY + errorOffset; }
+    float getRenderY(float alpha) const { return prevSimY + (simY - prevSimY) * alpha + errorOffset; }  // alpha: progress into the next tick
+    Uint32 getLastAcked() const { return lastAcked; }
+    Uint32 getPendingInputs() const { return nextSeq - 1 - lastAcked; }
+};
+
+#endif  // __PADDLE_PREDICTOR_H__
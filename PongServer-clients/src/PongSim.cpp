@@ -0,0 +1,207 @@
+#include "PongSim.h"
+#include "PaddlePredictor.h"
+#include "Crc32.h"
+
+PongSim::PongSim() {
+    setTickRate(TICK_RATE);
+    reset();
+}
+
+// 64-bit and integer-only, so every client scales to the same value
+Fixed PongSim::perTick(int speed) const {
+    return (Fixed)((Sint64)fixedFromInt(speed) * TICK_RATE / tickRate);
+}
+
+void PongSim::setTickRate(int ticksPerSecond) {
+    state.ballVX = (Fixed)((Sint64)state.ballVX * tickRate / ticksPerSecond);
+    state.ballVY = (Fixed)((Sint64)state.ballVY * tickRate / ticksPerSecond);
+    tickRate = ticksPerSecond;
+    paddleStep = perTick(PADDLE_SPEED);
+    startSpeed = perTick(BALL_START_SPEED);
+    minSpeedX = perTick(MIN_SPEED_X);
+    maxSpeedY = perTick(MAX_SPEED_Y);
+    clampedSpeedY = perTick(CLAMPED_SPEED_Y);
+}
+
+void PongSim::reset() {
+    state = PongState();
+    state.ballX = fixedFromInt(WIDTH / 2 - BALL_SIZE / 2);
+    state.ballY = fixedFromInt(HEIGHT / 2 - BALL_SIZE / 2);
+    state.ballVX = startSpeed;
+    state.ballVY = -startSpeed;
+    state.paddleX[0] = fixedFromInt(WIDTH / 4);
+    state.paddleX[1] = fixedFromInt(3 * WIDTH / 4 - PADDLE_WIDTH);
+    state.paddleY[0] = state.paddleY[1] = fixedFromInt(HEIGHT / 2 - PADDLE_HEIGHT / 2);
+}
+
+int PongSim::step(int buttons1, int buttons2) {
+    stepPaddle(state.paddleY[0], buttons1);
+    stepPaddle(state.paddleY[1], buttons2);
+    return stepBall();
+}
+
+int PongSim::stepBall() {
+    limitVelocity();
+    moveBall();
+    int events = collideWalls() | collidePaddles();
+    recentreIfOffscreen();
+    state.tick++;
+    return events;
+}
+
+void PongSim::stepPaddle(Fixed& y, int buttons) const {
+    bool up = (buttons & PaddleRules::UP) != 0;
+    bool down = (buttons & PaddleRules::DOWN) != 0;
+    if (up && !down && y >= fixedFromInt(PADDLE_TOP_LIMIT)) {
+        y -= paddleStep;
+    }
+    else if (down && !up && y <= fixedFromInt(PADDLE_BOTTOM_LIMIT)) {
+        y += paddleStep;
+    }
+}
+
+void PongSim::limitVelocity() {
+    // Same as the server, including a zero X velocity staying zero (signum(0) == 0)
+    if (fixedAbs(state.ballVX) < minSpeedX) {
+        state.ballVX = fixedSign(state.ballVX) * minSpeedX;
+    }
+    if (fixedAbs(state.ballVY) > maxSpeedY) {
+        state.ballVY = fixedSign(state.ballVY) * clampedSpeedY;
+    }
+}
+
+void PongSim::moveBall() {
+    state.ballX += state.ballVX;
+    state.ballY += state.ballVY;
+}
+
+int PongSim::collideWalls() {
+    const Fixed maxX = fixedFromInt(WIDTH - BALL_SIZE);
+    const Fixed maxY = fixedFromInt(HEIGHT - BALL_SIZE);
+    int events = 0;
+
+    // Reflect the overshoot back inside, as an elastic bounce would
+    if (state.ballY < 0) {
+        state.ballY = -state.ballY;
+        state.ballVY = fixedAbs(state.ballVY);
+        events |= EVENT_HIT_WALL_UP;
+    }
+    else if (state.ballY > maxY) {
+        state.ballY = 2 * maxY - state.ballY;
+        state.ballVY = -fixedAbs(state.ballVY);
+        events |= EVENT_HIT_WALL_DOWN;
+    }
+
+    if (state.ballX < 0) {
+        state.ballX = -state.ballX;
+        state.ballVX = fixedAbs(state.ballVX);
+        state.score[1]++;
+        events |= EVENT_HIT_WALL_LEFT;
+    }
+    else if (state.ballX > maxX) {
+        state.ballX = 2 * maxX - state.ballX;
+        state.ballVX = -fixedAbs(state.ballVX);
+        state.score[0]++;
+        events |= EVENT_HIT_WALL_RIGHT;
+    }
+    return events;
+}
+
+int PongSim::collidePaddles() {
+    const Fixed ballSize = fixedFromInt(BALL_SIZE);
+    const Fixed width = fixedFromInt(PADDLE_WIDTH);
+    const Fixed height = fixedFromInt(PADDLE_HEIGHT);
+    int events = 0;
+
+    for (int i = 0; i < 2; i++) {
+        Fixed left = state.paddleX[i];
+        Fixed top = state.paddleY[i];
+        if (state.ballX >= left + width || state.ballX + ballSize <= left ||
+            state.ballY >= top + height || state.ballY + ballSize <= top) {
+            continue;
+        }
+
+        // Work out which face was crossed from where the ball was before this tick
+        Fixed previousX = state.ballX - state.ballVX;
+        Fixed previousY = state.ballY - state.ballVY;
+        if (previousX + ballSize <= left) {
+            state.ballX = 2 * (left - ballSize) - state.ballX;
+            state.ballVX = -fixedAbs(state.ballVX);
+        }
+        else if (previousX >= left + width) {
+            state.ballX = 2 * (left + width) - state.ballX;
+            state.ballVX = fixedAbs(state.ballVX);
+        }
+        else if (previousY + ballSize <= top) {
+            state.ballY = top - ballSize;
+            state.ballVY = -fixedAbs(state.ballVY);
+        }
+        else {
+            state.ballY = top + height;
+            state.ballVY = fixedAbs(state.ballVY);
+        }
+        events |= i == 0 ? EVENT_BALL_HIT_BAT1 : EVENT_BALL_HIT_BAT2;
+    }
+    return events;
+}
+
+void PongSim::recentreIfOffscreen() {
+    // BallComponent.checkOffscreen: a ball pushed out of the screen is put back in the middle
+    const Fixed ballSize = fixedFromInt(BALL_SIZE);
+    if (state.ballX + ballSize < 0 || state.ballX > fixedFromInt(WIDTH) ||
+        state.ballY + ballSize < 0 || state.ballY > fixedFromInt(HEIGHT)) {
+        state.ballX = fixedFromInt(WIDTH / 2);
+        state.ballY = fixedFromInt(HEIGHT / 2);
+    }
+}
+
+void PongSim::pack(const PongState& state, Sint32 fields[STATE_FIELDS]) {
+    fields[0] = (Sint32)state.tick;
+    fields[1] = state.ballX;
+    fields[2] = state.ballY;
+    fields[3] = state.ballVX;
+    fields[4] = state.ballVY;
+    fields[5] = state.paddleX[0];
+    fields[6] = state.paddleY[0];
+    fields[7] = state.paddleX[1];
+    fields[8] = state.paddleY[1];
+    fields[9] = state.score[0];
+    fields[10] = state.score[1];
+}
+
+void PongSim::unpack(const Sint32 fields[STATE_FIELDS], PongState& state) {
+    state.tick = (Uint32)fields[0];
+    state.ballX = fields[1];
+    state.ballY = fields[2];
+    state.ballVX = fields[3];
+    state.ballVY = fields[4];
+    state.paddleX[0] = fields[5];
+    state.paddleY[0] = fields[6];
+    state.paddleX[1] = fields[7];
+    state.paddleY[1] = fields[8];
+    state.score[0] = fields[9];
+    state.score[1] = fields[10];
+}
+
+const char* PongSim::fieldName(int index) {
+    static const char* NAMES[STATE_FIELDS] = {
+        "tick", "ballX", "ballY", "ballVX", "ballVY", "paddle1X", "paddle1Y", "paddle2X", "paddle2Y", "score1", "score2"
+    };
+    return index >= 0 && index < STATE_FIELDS ? NAMES[index] : "?";
+}
+
+Uint32 PongSim::hashState(const PongState& state, Uint32 seed) {
+    Sint32 fields[STATE_FIELDS];
+    pack(state, fields);
+
+    // Fixed byte order so every platform hashes the same bytes
+    Uint8 bytes[STATE_FIELDS * 4];
+    for (int i = 0; i < STATE_FIELDS; i++) {
+        Uint32 value = (Uint32)fields[i];
+        bytes[i * 4] = (Uint8)value;
+        bytes[i * 4 + 1] = (Uint8)(value >> 8);
+        bytes[i * 4 + 2] = (Uint8)(value >> 16);
+        bytes[i * 4 + 3] = (Uint8)(value >> 24);
+    }
+    return crc32(seed, bytes, sizeof(bytes));
+}
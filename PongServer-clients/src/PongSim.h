@@ -0,0 +1,94 @@
+#ifndef __PONG_SIM_H__
+#define __PONG_SIM_H__
+
+#include "SDL.h"
+#include "Fixed.h"
+
+// Events raised by a simulation tick; one per server HIT_* / BALL_HIT_BAT* message
+enum PongEvent {
+    EVENT_HIT_WALL_LEFT = 1 << 0,   // Ball reached the left wall: player 2 scores
+    EVENT_HIT_WALL_RIGHT = 1 << 1,  // Ball reached the right wall: player 1 scores
+    EVENT_HIT_WALL_UP = 1 << 2,
+    EVENT_HIT_WALL_DOWN = 1 << 3,
+    EVENT_BALL_HIT_BAT1 = 1 << 4,
+    EVENT_BALL_HIT_BAT2 = 1 << 5,
+};
+const int EVENT_COUNT = 6;
+
+// PongState: the complete simulation state. Plain data, so copying it is a save/restore.
+struct PongState {
+    Uint32 tick = 0;
+    Fixed ballX = 0;   // Top-left of the ball's bounding box
+    Fixed ballY = 0;
+    Fixed ballVX = 0;  // Ball velocity in pixels per tick
+    Fixed ballVY = 0;
+    Fixed paddleX[2] = { 0, 0 };  // Top-left of each paddle
+    Fixed paddleY[2] = { 0, 0 };
+    int score[2] = { 0, 0 };
+};
+
+// PongSim: deterministic fixed-point version of the server's game.
+// The layout comes from PongApp/PongFactory, paddle movement from PlayerCharacterComponent
+// and the velocity clamps from BallComponent.limitVelocity. Walls and paddles reflect the
+// ball perfectly (restitution 1); the left and right walls also score, as on the server.
+// Speeds are given per tick at TICK_RATE; at another tick rate they are scaled to the tick's
+// length, so the game runs at the same speed in real time whatever the rate.
+class PongSim {
+private:
+    int tickRate = TICK_RATE;
+    Fixed paddleStep;     // The speeds below, per tick at tickRate
+    Fixed startSpeed;
+    Fixed minSpeedX;
+    Fixed maxSpeedY;
+    Fixed clampedSpeedY;
+
+    Fixed perTick(int speed) const;  // A speed per tick at TICK_RATE, per tick at tickRate
+
+public:
+    static const int WIDTH = 800;
+    static const int HEIGHT = 600;
+    static const int BALL_SIZE = 10;       // Circle of radius 5
+    static const int PADDLE_WIDTH = 20;
+    static const int PADDLE_HEIGHT = 60;
+    static const int TICK_RATE = 60;       // Ticks per second
+    static const int BALL_START_SPEED = 5; // 5 * 60 px/s on both axes, up and to the right
+    static const int PADDLE_SPEED = 7;     // 420 px/s
+    static const int PADDLE_TOP_LIMIT = 7; // moveUp() only moves while y >= this
+    static const int PADDLE_BOTTOM_LIMIT = 775;  // moveDown() only moves while y <= this (the server uses the app width)
+    static const int MIN_SPEED_X = 5;      // limitVelocity: slower X speeds are raised to this
+    static const int MAX_SPEED_Y = 10;     // limitVelocity: faster Y speeds...
+    static const int CLAMPED_SPEED_Y = 5;  // ...are dropped to this
+
+    PongState state;
+
+    PongSim();
+
+    // Ticks per second. Rescales the ball's current velocity; set it the same on every
+    // simulation that has to agree, as per-tick speeds round differently at each rate
+    void setTickRate(int ticksPerSecond);
+    int getTickRate() const { return tickRate; }
+
+    void reset();  // Ball and paddles at their spawn positions, scores cleared
+    int step(int buttons1, int buttons2);  // Advance one tick; returns PongEvent bits
+    int stepBall();  // Advance the ball one tick without moving the paddles
+
+    // The phases of stepBall(), in order, for callers that drive the ball themselves
+    void limitVelocity();
+    void moveBall();
+    int collideWalls();
+    int collidePaddles();
+    void recentreIfOffscreen();
+
+    void stepPaddle(Fixed& y, int buttons) const;  // PaddleRules::step in fixed point
+
+    // Flat form of a PongState, for hashing, sending and dumping
+    static const int STATE_FIELDS = 11;
+    static void pack(const PongState& state, Sint32 fields[STATE_FIELDS]);
+    static void unpack(const Sint32 fields[STATE_FIELDS], PongState& state);
+    static const char* fieldName(int index);
+
+    // CRC-32 of the state's fields in little-endian order, continuing from `seed`
+    static Uint32 hashState(const PongState& state, Uint32 seed);
+};
+
+#endif  // __PONG_SIM_H__
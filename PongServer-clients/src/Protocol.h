@@ -0,0 +1,24 @@
+#ifndef __PROTOCOL_H__
+#define __PROTOCOL_H__
+
+// Handshake sent as the first message on every connection:
+//   client: HELLO,<protocol version>,<capability bits>
+//   server: WELCOME,<protocol version>,<player slot>,<tick rate>,<chosen capability bits>
+// The server picks the lower of the two versions and the capabilities both sides support;
+// slot 0 means spectator. Values must match NetworkMessages.java on the server.
+const int PROTOCOL_VERSION = 1;
+
+enum Capability {
+    CAP_CIPHER = 1,            // XOR stage on the channel
+    CAP_BINARY_SNAPSHOTS = 2,  // Snapshots as binary records instead of text
+    CAP_COMPRESSION = 4,       // Compressed messages
+    CAP_SHM_TRANSPORT = 8,     // Shared-memory transport on the same machine
+};
+
+// What this client implements
+const int CLIENT_CAPABILITIES = CAP_CIPHER | CAP_SHM_TRANSPORT;
+
+// XOR key of the cipher stage, shared with the server
+const char* const CIPHER_KEY = "jnmvk!_!aU5N_3iKdodDD6Z3JzbWSMUiNnnG_b8IGuGcJgQPPajpWR8y6YWqz29n";
+
+#endif  // __PROTOCOL_H__
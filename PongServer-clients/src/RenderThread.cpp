@@ -0,0 +1,240 @@
+#include "RenderThread.h"
+#include "MyGame.h"
+#include "Timing.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+RenderThread::RenderThread(MyGame* game) : game(game) {
+}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+bool RenderThread::start(SDL_Window* targetWindow) {
+    window = targetWindow;
+    if (!threaded) {
+        return createRenderer();
+    }
+
+    running = true;
+    thread = SDL_CreateThread(threadMain, "RenderThread", this);
+    if (!thread) {
+        std::cerr << "Failed to start the render thread: " << SDL_GetError() << std::endl;
+        running = false;
+        return false;
+    }
+
+    // Assets are uploaded before the first frame, so wait for the thread to be ready
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queueChanged.wait(lock, [this] { return started; });
+    return !startFailed;
+}
+
+int RenderThread::threadMain(void* self) {
+    RenderThread* render = (RenderThread*)self;
+    bool ok = render->createRenderer();
+    {
+        std::lock_guard<std::mutex> lock(render->queueMutex);
+        render->started = true;
+        render->startFailed = !ok;
+        render->running = ok;
+    }
+    render->queueChanged.notify_all();
+    if (!ok) {
+        return 1;
+    }
+
+    while (true) {
+        FramePacket packet;
+        double waitStart = nowMs();
+        {
+            std::unique_lock<std::mutex> lock(render->queueMutex);
+            render->queueChanged.wait(lock, [render] { return !render->queue.empty() || !render->running; });
+            if (!render->running) {
+                break;
+            }
+            packet = std::move(render->queue.front());
+            render->queue.pop_front();
+            render->consumed++;
+        }
+        render->queueChanged.notify_all();  // The main thread may build the next frame
+
+        // A long wait for work (the main loop idling) is not a slow frame
+        if (nowMs() - waitStart > render->pacer.getFrameMs()) {
+            std::lock_guard<std::mutex> lock(render->statsMutex);
+            render->pacer.start();
+        }
+        render->draw(packet);
+    }
+
+    render->destroyRenderer();
+    return 0;
+}
+
+bool RenderThread::createRenderer() {
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | pacer.rendererFlags());
+    if (nullptr == renderer) {
+        std::cout << "Failed to create renderer: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    game->startup.mark("renderer created");
+
+    // Without VSync support, cap at the refresh rate ourselves
+    SDL_RendererInfo rendererInfo;
+    if (pacer.mode == PACE_VSYNC && SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && !(rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC)) {
+        std::cout << "VSync is not available; capping at " << pacer.targetFps << " fps instead" << std::endl;
+        pacer.mode = PACE_FIXED;
+    }
+
+    game->loadTextures(renderer);  // Load textures and assets for the game
+    pacer.start();
+    return true;
+}
+
+void RenderThread::destroyRenderer() {
+    if (renderer) {
+        game->destroyTextures();  // Textures belong to the renderer and go first
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+}
+
+void RenderThread::draw(const FramePacket& packet) {
+    double drawStart = nowMs();
+
+    // Clear the screen
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);  // Set the draw color to black
+    SDL_RenderClear(renderer);  // Clear the screen
+
+    game->drawFrame(renderer, packet);
+
+    double presentStart = nowMs();
+    SDL_RenderPresent(renderer);  // Present the rendered frame (waits for the vblank with VSync)
+    double presentEnd = nowMs();
+    if (!presentedFirst) {
+        presentedFirst = true;
+        game->startup.mark("first frame presented");
+        game->startup.print();
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    pacer.endFrame();  // Wait for the next frame's deadline when the rate is capped
+
+    double latency = presentEnd - packet.builtAt;
+    stats.simulateMs += packet.simulateMs;
+    stats.buildMs += packet.buildMs;
+    stats.queueMs += drawStart - packet.builtAt;
+    stats.drawMs += presentStart - drawStart;
+    stats.presentMs += presentEnd - presentStart;
+    stats.latencyMs += latency;
+    stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
+    stats.frames++;
+}
+
+void RenderThread::submit(FramePacket&& packet) {
+    packet.frame = nextFrame++;
+    if (!threaded) {
+        if (renderer) {
+            draw(packet);
+            drewInline = true;
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        while ((int)queue.size() >= std::max(1, maxQueuedFrames)) {
+            queue.pop_front();  // Superseded before it was drawn
+            dropped++;
+        }
+        queue.push_back(std::move(packet));
+    }
+    queueChanged.notify_all();
+}
+
+void RenderThread::waitForNextFrame() {
+    if (!threaded) {
+        if (!drewInline) {
+            pacer.skipFrame();  // Nothing was drawn, so nothing waited for the frame slot
+        }
+        drewInline = false;
+        return;
+    }
+
+    // Return as soon as the render thread takes a packet, so the next one is built just in
+    // time, but never wait longer than a frame: input and simulation keep running even
+    // while a present is blocked
+    if (pacer.mode == PACE_UNCAPPED) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(queueMutex);
+    auto timeout = std::chrono::microseconds((long long)(pacer.getFrameMs() * 1000));
+    queueChanged.wait_for(lock, timeout, [this] { return consumed != lastWaitedConsumed || !running; });
+    lastWaitedConsumed = consumed;
+}
+
+void RenderThread::idleEnded() {
+    if (!threaded) {
+        pacer.start();  // The render thread notices long waits itself
+    }
+}
+
+void RenderThread::stop() {
+    if (thread) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            running = false;
+            queue.clear();
+        }
+        queueChanged.notify_all();
+        SDL_WaitThread(thread, nullptr);
+        thread = nullptr;
+    }
+    else {
+        destroyRenderer();
+    }
+}
+
+PipelineStats RenderThread::getStats() const {
+    int droppedFrames;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        droppedFrames = dropped;
+    }
+    std::lock_guard<std::mutex> lock(statsMutex);
+    PipelineStats average = stats;
+    average.dropped = droppedFrames;
+    if (stats.frames > 0) {
+        average.simulateMs /= stats.frames;
+        average.buildMs /= stats.frames;
+        average.queueMs /= stats.frames;
+        average.drawMs /= stats.frames;
+        average.presentMs /= stats.frames;
+        average.latencyMs /= stats.frames;
+    }
+    return average;
+}
+
+void RenderThread::resetStats() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        dropped = 0;
+    }
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats = PipelineStats();
+}
+
+void RenderThread::printStats() const {
+    PipelineStats average = getStats();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        pacer.printStats();
+    }
+    std::cout << "Pipeline (" << (threaded ? "render thread" : "single thread") << "): simulate " << average.simulateMs
+              << " ms, build " << average.buildMs << " ms, queued " << average.queueMs << " ms, draw " << average.drawMs
+              << " ms, present " << average.presentMs << " ms, built-to-presented " << average.latencyMs << " ms (max "
+              << average.maxLatencyMs << " ms), " << average.dropped << " dropped of " << average.frames + average.dropped
+              << std::endl;
+}
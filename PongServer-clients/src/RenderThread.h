@@ -0,0 +1,80 @@
+#ifndef __RENDER_THREAD_H__
+#define __RENDER_THREAD_H__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "SDL.h"
+#include "FramePacket.h"
+#include "FramePacer.h"
+
+class MyGame;
+
+// PipelineStats: average time per frame in each pipeline stage since the last reset (ms)
+struct PipelineStats {
+    double simulateMs = 0;  // Main thread: events, update and simulation ticks
+    double buildMs = 0;     // Main thread: building the frame packet
+    double queueMs = 0;     // Packet waiting for the render thread
+    double drawMs = 0;      // Render thread: clear and draw calls
+    double presentMs = 0;   // Render thread: SDL_RenderPresent, including any VSync wait
+    double latencyMs = 0;   // Packet built to present finished
+    double maxLatencyMs = 0;
+    int frames = 0;         // Packets presented
+    int dropped = 0;        // Packets replaced by a newer one before they were drawn
+};
+
+// RenderThread: owns the SDL_Renderer and draws frame packets submitted by the main thread.
+// The renderer, and every texture, is created on this thread: assets are uploaded in start()
+// and destroyed in stop(). The queue holds at most maxQueuedFrames packets; submitting to a
+// full queue drops the oldest waiting packet, so a stalled present costs a skipped frame
+// rather than latency. With threaded = false the same calls draw on the caller's thread.
+class RenderThread {
+private:
+    MyGame* game;
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    SDL_Thread* thread = nullptr;
+
+    mutable std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<FramePacket> queue;  // Packets waiting to be drawn, oldest first
+    bool running = false;
+    bool started = false;           // start() has finished, successfully or not
+    bool startFailed = false;
+    Uint32 consumed = 0;            // Packets taken by the render thread so far
+    Uint32 lastWaitedConsumed = 0;  // consumed at the previous waitForNextFrame()
+    bool drewInline = false;        // Unthreaded: a frame was drawn since the last waitForNextFrame()
+    Uint32 nextFrame = 0;
+    bool presentedFirst = false;    // The first frame has been presented (ends the startup timeline)
+    int dropped = 0;                // Packets superseded in the queue (guarded by queueMutex)
+
+    // Guards stats and the pacer while the render thread runs. The main thread only takes it
+    // to read statistics, never while submitting, since the render thread holds it while pacing.
+    mutable std::mutex statsMutex;
+    PipelineStats stats;
+
+    static int threadMain(void* self);
+    bool createRenderer();  // Create the renderer and upload assets on the calling thread
+    void destroyRenderer();
+    void draw(const FramePacket& packet);  // Draw, present and record timings
+
+public:
+    bool threaded = true;     // Draw on a separate thread
+    int maxQueuedFrames = 1;  // Packets allowed to wait for the render thread
+    FramePacer pacer;         // Paces presents; owned by the rendering thread once started
+
+    explicit RenderThread(MyGame* game);
+    ~RenderThread();
+
+    bool start(SDL_Window* window);  // Create the renderer and load assets; false on failure
+    void submit(FramePacket&& packet);  // Hand over a frame (never blocks on drawing when threaded)
+    void waitForNextFrame();  // Pace the caller to the render rate, at most one frame interval
+    void idleEnded();  // The caller slept waiting for events; that time is not a frame
+    void stop();  // Draw nothing more, release assets and the renderer
+
+    PipelineStats getStats() const;
+    void resetStats();
+    void printStats() const;
+};
+
+#endif  // __RENDER_THREAD_H__
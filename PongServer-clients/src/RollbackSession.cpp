@@ -0,0 +1,142 @@
+#include "RollbackSession.h"
+#include <algorithm>
+#include <sstream>
+
+RollbackSession::Frame& RollbackSession::frameFor(Sint32 tick) {
+    Frame& frame = frames[tick % RING_SIZE];
+    if (frame.tick != tick) {
+        frame = Frame();
+        frame.tick = tick;
+    }
+    return frame;
+}
+
+void RollbackSession::start(int localPlayerIndex, int delay) {
+    localPlayer = localPlayerIndex;
+    inputDelay = std::max(0, std::min(delay, RING_SIZE / 4));
+    rollbackWindow = std::max(1, std::min(rollbackWindow, RING_SIZE / 2));
+    sim.reset();
+    for (Frame& frame : frames) {
+        frame = Frame();
+    }
+    lastConfirmedRemote = -1;
+    lastLocalScheduled = -1;
+    earliestMismatch = -1;
+    lastRemoteInput = 0;
+    stats = RollbackStats();
+
+    // The first inputDelay ticks have no local input, and none from the other peer either
+    for (Sint32 tick = 0; tick < inputDelay; tick++) {
+        Frame& frame = frameFor(tick);
+        frame.confirmed = true;
+        lastConfirmedRemote = tick;
+        lastLocalScheduled = tick;
+    }
+    started = true;
+}
+
+Sint32 RollbackSession::addLocalInput(int buttons) {
+    Sint32 tick = getTick() + inputDelay;
+    if (tick <= lastLocalScheduled) {
+        return -1;  // Already have input for this tick (we are stalled)
+    }
+    frameFor(tick).input[localPlayer] = buttons;
+    lastLocalScheduled = tick;
+    return tick;
+}
+
+void RollbackSession::addRemoteInput(Sint32 tick, int buttons) {
+    if (tick <= lastConfirmedRemote || tick - getTick() >= RING_SIZE - rollbackWindow) {
+        return;  // Duplicate, or too far ahead to store
+    }
+
+    Frame& frame = frameFor(tick);
+    if (tick < getTick() && frame.input[remoteIndex()] != buttons) {
+        // Already simulated with the wrong prediction
+        stats.mispredictedInputs++;
+        if (earliestMismatch < 0 || tick < earliestMismatch) {
+            earliestMismatch = tick;
+        }
+    }
+    frame.input[remoteIndex()] = buttons;
+    frame.confirmed = true;
+    lastRemoteInput = buttons;
+
+    // Extend the run of confirmed ticks as far as it now reaches
+    while (true) {
+        const Frame& next = frames[(lastConfirmedRemote + 1) % RING_SIZE];
+        if (next.tick != lastConfirmedRemote + 1 || !next.confirmed) {
+            break;
+        }
+        lastConfirmedRemote++;
+    }
+}
+
+int RollbackSession::advance() {
+    if (!started) {
+        return -1;
+    }
+
+    // Restore the state from before the first wrong prediction and run forward again
+    if (earliestMismatch >= 0) {
+        Sint32 current = getTick();
+        sim.state = frameFor(earliestMismatch).saved;
+        for (Sint32 tick = earliestMismatch; tick < current; tick++) {
+            Frame& frame = frameFor(tick);
+            if (!frame.confirmed) {
+                frame.input[remoteIndex()] = lastRemoteInput;  // Re-predict from the newest input
+            }
+            frame.saved = sim.state;
+            sim.step(frame.input[0], frame.input[1]);
+        }
+        stats.rollbacks++;
+        stats.resimulatedTicks += current - earliestMismatch;
+        stats.maxRollbackDepth = std::max(stats.maxRollbackDepth, (int)(current - earliestMismatch));
+        earliestMismatch = -1;
+    }
+
+    // Wait for the other player rather than predict further than the window allows
+    Sint32 tick = getTick();
+    if (tick - lastConfirmedRemote > rollbackWindow || tick > lastLocalScheduled) {
+        stats.stalls++;
+        return -1;
+    }
+
+    Frame& frame = frameFor(tick);
+    if (!frame.confirmed) {
+        frame.input[remoteIndex()] = lastRemoteInput;
+    }
+    frame.saved = sim.state;
+    int events = sim.step(frame.input[0], frame.input[1]);
+    stats.predictedTicks = getTick() - 1 - lastConfirmedRemote;
+    return events;
+}
+
+bool RollbackSession::getStateAfter(Sint32 tick, PongState& out) {
+    if (tick < 0 || tick >= getTick()) {
+        return false;
+    }
+    if (tick == getTick() - 1) {
+        out = sim.state;
+        return true;
+    }
+    const Frame& next = frames[(tick + 1) % RING_SIZE];
+    if (next.tick != tick + 1) {
+        return false;  // Overwritten
+    }
+    out = next.saved;
+    return true;
+}
+
+std::string RollbackSession::describeInputs(Sint32 fromTick, Sint32 toTick) {
+    std::ostringstream out;
+    out << "tick player1 player2 remoteConfirmed" << std::endl;
+    for (Sint32 tick = std::max((Sint32)0, fromTick); tick <= toTick; tick++) {
+        const Frame& frame = frames[tick % RING_SIZE];
+        if (frame.tick != tick) {
+            continue;
+        }
+        out << tick << " " << frame.input[0] << " " << frame.input[1] << " " << (frame.confirmed ? "yes" : "no") << std::endl;
+    }
+    return out.str();
+}
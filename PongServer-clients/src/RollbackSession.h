@@ -0,0 +1,78 @@
+#ifndef __ROLLBACK_SESSION_H__
+#define __ROLLBACK_SESSION_H__
+
+#include <algorithm>
+#include <string>
+#include "SDL.h"
+#include "PongSim.h"
+
+// Counters for observing a rollback session
+struct RollbackStats {
+    int rollbacks = 0;            // Times state was restored and resimulated
+    int resimulatedTicks = 0;     // Ticks run again because of rollbacks
+    int maxRollbackDepth = 0;     // Deepest rollback so far (ticks)
+    int mispredictedInputs = 0;   // Remote inputs that differed from the prediction used
+    int stalls = 0;               // Ticks not run because the remote player was a full window behind
+    int predictedTicks = 0;       // Ticks currently simulated on a predicted remote input
+};
+
+// RollbackSession: peer-to-peer style rollback netcode over a deterministic PongSim.
+// Both peers simulate every tick themselves and only exchange input frames (through the
+// server, which relays them). Local input is scheduled inputDelay ticks ahead; a missing
+// remote input is predicted by repeating the last one received. When the real input turns
+// out different, the state saved before that tick is restored and the ticks since are
+// resimulated. The simulation never runs more than rollbackWindow ticks past the last
+// confirmed remote input, so a rollback is bounded in depth.
+class RollbackSession {
+private:
+    static const int RING_SIZE = 128;  // Ticks of inputs and saved states kept
+
+    struct Frame {
+        Sint32 tick = -1;       // Tick this slot currently describes
+        int input[2] = { 0, 0 };
+        bool confirmed = false; // Remote input received (the local one always is)
+        PongState saved;        // State before this tick was simulated
+    };
+
+    Frame frames[RING_SIZE];
+    PongSim sim;
+    int localPlayer = 0;             // 0 or 1
+    Sint32 lastConfirmedRemote = -1; // Every remote input up to this tick has been received
+    Sint32 lastLocalScheduled = -1;  // Highest tick with local input
+    Sint32 earliestMismatch = -1;    // Oldest tick whose prediction proved wrong, -1 if none
+    int lastRemoteInput = 0;         // Most recent remote input received, used as the prediction
+    bool started = false;
+    RollbackStats stats;
+
+    Frame& frameFor(Sint32 tick);
+    int remoteIndex() const { return 1 - localPlayer; }
+
+public:
+    int inputDelay = 2;       // Ticks between reading local input and applying it (both peers must agree)
+    int rollbackWindow = 8;   // Most ticks the simulation may run ahead of confirmed input
+
+    void start(int localPlayerIndex, int delay);  // Begin at tick 0 from the spawn layout
+    void setTickRate(int ticksPerSecond) { sim.setTickRate(ticksPerSecond); }  // Both peers must agree
+    void stop() { started = false; }  // The match ended (a player disconnected)
+    bool isStarted() const { return started; }
+
+    // Record this tick's local input; returns the tick it will be applied on (send it with that tick)
+    Sint32 addLocalInput(int buttons);
+    void addRemoteInput(Sint32 tick, int buttons);  // Input received from the other peer
+
+    // Roll back if needed, then simulate the next tick. Returns the PongEvent bits of the
+    // new tick, or -1 if the session is waiting for the remote player.
+    int advance();
+
+    const PongState& getState() const { return sim.state; }
+    Sint32 getTick() const { return (Sint32)sim.state.tick; }
+    Sint32 getFrameAdvantage() const { return getTick() - 1 - lastConfirmedRemote; }  // Ticks run on prediction
+    const RollbackStats& getStats() const { return stats; }
+
+    // Newest tick that can no longer be rolled back (both inputs known and simulated)
+    Sint32 getFinalTick() const { return std::min(lastConfirmedRemote, getTick() - 1); }
+    bool getStateAfter(Sint32 tick, PongState& out);  // State once `tick` has run, if still stored
+    std::string describeInputs(Sint32 fromTick, Sint32 toTick);  // One line per stored tick, for dumps
+};
+
+#endif  // __ROLLBACK_SESSION_H__
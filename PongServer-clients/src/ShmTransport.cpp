@@ -0,0 +1,461 @@
+#include "ShmTransport.h"
+#include <iostream>
+
+#ifdef __linux__
+
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// -------------------------------------------------
+// Shared Memory Layout
+// -------------------------------------------------
+
+// Ring positions are free-running byte counters; the offset into the data area is
+// position & (size - 1). Each record is a 32-bit length followed by the payload and
+// a terminating NUL, padded to 8 bytes. A record that would straddle the end of the
+// data area is preceded by a WRAP marker telling the reader to skip to the start.
+struct ShmTransport::Ring {
+    alignas(64) std::atomic<Uint32> head;  // Bytes published by the writer (reader futex word)
+    alignas(64) std::atomic<Uint32> tail;  // Bytes consumed by the reader (writer futex word)
+    alignas(64) std::atomic<Uint32> readerWaiting;  // Set while the reader sleeps on head
+    std::atomic<Uint32> writerWaiting;  // Set while the writer sleeps on tail
+    Uint32 size;  // Size of the data area (power of two)
+    Uint32 dataOffset;  // Offset of the data area from the start of the segment
+};
+
+struct ShmTransport::Segment {
+    std::atomic<Uint32> magic;  // Written last by the creator, checked by attach
+    Uint32 version;
+    std::atomic<Uint32> closed;  // Set by either side on close
+    Ring toPeer;  // Written by the creator, read by the attached peer
+    Ring toOwner;  // Written by the attached peer, read by the creator
+};
+
+static const Uint32 SHM_MAGIC = 0x50534D31;  // "PSM1"
+static const Uint32 SHM_VERSION = 1;
+static const Uint32 WRAP_MARKER = 0xFFFFFFFF;
+static const Uint32 RECORD_HEADER = sizeof(Uint32);
+static const int SPIN_ITERATIONS = 2000;  // Busy-wait before sleeping, keeps wakeups in the microsecond range
+static const Uint32 CLOSE_POLL_MS = 100;  // Upper bound on a single futex sleep so close() is always noticed
+
+static Uint32 recordSize(Uint32 length) {
+    return (RECORD_HEADER + length + 1 + 7) & ~7u;  // Header, payload, NUL, 8-byte alignment
+}
+
+static int futexWait(std::atomic<Uint32>* word, Uint32 expected, Uint32 timeoutMs) {
+    timespec ts;
+    ts.tv_sec = timeoutMs / 1000;
+    ts.tv_nsec = (timeoutMs % 1000) * 1000000L;
+    return syscall(SYS_futex, reinterpret_cast<Uint32*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+static void futexWake(std::atomic<Uint32>* word) {
+    syscall(SYS_futex, reinterpret_cast<Uint32*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// Wait until `ready` holds, the segment is closed or timeoutMs passes.
+// `word` is the futex the other side changes and wakes when `ready` may have become true.
+template <typename Ready>
+static bool waitFor(Ready ready, std::atomic<Uint32>* word, std::atomic<Uint32>* waiting,
+                    std::atomic<Uint32>* closed, Uint32 timeoutMs) {
+    int spins = timeoutMs > 0 ? SPIN_ITERATIONS : 1;  // A zero timeout is a plain poll
+    for (int i = 0; i < spins; i++) {
+        if (ready()) {
+            return true;
+        }
+        cpuRelax();
+    }
+
+    Uint32 start = SDL_GetTicks();
+    while (!closed->load(std::memory_order_acquire)) {
+        Uint32 observed = word->load(std::memory_order_acquire);
+        waiting->store(1, std::memory_order_seq_cst);
+        if (ready()) {
+            waiting->store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        Uint32 elapsed = SDL_GetTicks() - start;
+        if (elapsed >= timeoutMs) {
+            waiting->store(0, std::memory_order_relaxed);
+            return false;
+        }
+        Uint32 remaining = timeoutMs - elapsed;
+        futexWait(word, observed, remaining < CLOSE_POLL_MS ? remaining : CLOSE_POLL_MS);
+        waiting->store(0, std::memory_order_relaxed);
+
+        if (ready()) {
+            return true;
+        }
+    }
+    return ready();
+}
+
+// -------------------------------------------------
+// Setup and Teardown
+// -------------------------------------------------
+
+bool ShmTransport::map(int fd, size_t size) {
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory " << name << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    segment = static_cast<Segment*>(memory);
+    mappedSize = size;
+    return true;
+}
+
+static bool isValidRingSize(Uint32 size) {
+    return size >= 4096 && (size & (size - 1)) == 0;
+}
+
+// The ring geometry comes from a segment the peer can write, so it is checked against the
+// mapping once and then kept on this side; later changes to it in the segment are ignored
+bool ShmTransport::bindRings(bool isOwner) {
+    Ring* tx = isOwner ? &segment->toPeer : &segment->toOwner;
+    Ring* rx = isOwner ? &segment->toOwner : &segment->toPeer;
+    Ring* rings[2] = { tx, rx };
+    Uint32 sizes[2];
+    Uint32 offsets[2];
+    for (int i = 0; i < 2; i++) {
+        sizes[i] = rings[i]->size;
+        offsets[i] = rings[i]->dataOffset;
+        if (!isValidRingSize(sizes[i]) || offsets[i] < sizeof(Segment) || size_t(offsets[i]) + sizes[i] > mappedSize) {
+            return false;
+        }
+    }
+
+    owner = isOwner;
+    txRing = tx;
+    rxRing = rx;
+    txSize = sizes[0];
+    rxSize = sizes[1];
+    txData = reinterpret_cast<char*>(segment) + offsets[0];
+    rxData = reinterpret_cast<char*>(segment) + offsets[1];
+    return true;
+}
+
+ShmTransport* ShmTransport::create(const char* name, Uint32 ringSize) {
+    if (!isValidRingSize(ringSize)) {
+        std::cerr << "Shared memory ring size must be a power of two >= 4096" << std::endl;
+        return nullptr;
+    }
+
+    ShmTransport* transport = new ShmTransport();
+    transport->name = name;
+
+    shm_unlink(name);  // Remove a segment left behind by a crashed host
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "Failed to create shared memory " << name << ": " << strerror(errno) << std::endl;
+        delete transport;
+        return nullptr;
+    }
+
+    size_t headerSize = (sizeof(Segment) + 63) & ~size_t(63);
+    size_t size = headerSize + 2 * size_t(ringSize);
+    if (ftruncate(fd, size) != 0 || !transport->map(fd, size)) {
+        shm_unlink(name);
+        delete transport;
+        return nullptr;
+    }
+
+    Segment* segment = new (transport->segment) Segment();
+    segment->version = SHM_VERSION;
+    segment->closed.store(0);
+    Ring* rings[2] = { &segment->toPeer, &segment->toOwner };
+    for (int i = 0; i < 2; i++) {
+        rings[i]->head.store(0);
+        rings[i]->tail.store(0);
+        rings[i]->readerWaiting.store(0);
+        rings[i]->writerWaiting.store(0);
+        rings[i]->size = ringSize;
+        rings[i]->dataOffset = Uint32(headerSize + i * size_t(ringSize));
+    }
+    segment->magic.store(SHM_MAGIC, std::memory_order_release);
+
+    transport->bindRings(true);  // Laid out above, so always valid
+    return transport;
+}
+
+ShmTransport* ShmTransport::attach(const char* name) {
+    ShmTransport* transport = new ShmTransport();
+    transport->name = name;
+
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "Failed to open shared memory " << name << ": " << strerror(errno) << std::endl;
+        delete transport;
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(Segment)) {
+        std::cerr << "Shared memory " << name << " is not a transport segment" << std::endl;
+        ::close(fd);
+        delete transport;
+        return nullptr;
+    }
+    if (!transport->map(fd, size_t(info.st_size))) {
+        delete transport;
+        return nullptr;
+    }
+
+    Segment* segment = transport->segment;
+    if (segment->magic.load(std::memory_order_acquire) != SHM_MAGIC || segment->version != SHM_VERSION) {
+        std::cerr << "Shared memory " << name << " has an unknown layout" << std::endl;
+        delete transport;
+        return nullptr;
+    }
+
+    if (!transport->bindRings(false)) {
+        std::cerr << "Shared memory " << name << " has rings outside the segment" << std::endl;
+        delete transport;
+        return nullptr;
+    }
+    return transport;
+}
+
+ShmTransport::~ShmTransport() {
+    close();
+    if (segment) {
+        munmap(segment, mappedSize);
+        segment = nullptr;
+    }
+    if (owner) {
+        shm_unlink(name.c_str());
+    }
+}
+
+void ShmTransport::close() {
+    if (!segment || !rxRing) {
+        return;
+    }
+    segment->closed.store(1, std::memory_order_release);
+    futexWake(&rxRing->head);
+    futexWake(&txRing->tail);
+    futexWake(&txRing->head);
+    futexWake(&rxRing->tail);
+}
+
+// -------------------------------------------------
+// Zero-copy Message Access
+// -------------------------------------------------
+
+int ShmTransport::acquireMessage(char*& data, Uint32 timeoutMs) {
+    if (!segment) {
+        return -1;
+    }
+    Ring* ring = rxRing;
+
+    for (;;) {
+        Uint32 tail = ring->tail.load(std::memory_order_relaxed);
+        auto available = [ring, tail]() { return ring->head.load(std::memory_order_acquire) != tail; };
+        if (!available()) {
+            if (!waitFor(available, &ring->head, &ring->readerWaiting, &segment->closed, timeoutMs)) {
+                return segment->closed.load(std::memory_order_acquire) ? -1 : TIMED_OUT;
+            }
+        }
+
+        Uint32 offset = tail & (rxSize - 1) & ~7u;  // Records are 8-byte aligned, whatever the peer wrote
+        Uint32 length;
+        memcpy(&length, rxData + offset, sizeof(length));
+
+        if (length == WRAP_MARKER) {
+            // Skip the unused end of the data area and read from the start
+            ring->tail.store(tail + (rxSize - offset), std::memory_order_seq_cst);
+            if (ring->writerWaiting.load(std::memory_order_seq_cst)) {
+                futexWake(&ring->tail);
+            }
+            continue;
+        }
+
+        if (length > rxSize / 2 || recordSize(length) > rxSize - offset) {
+            std::cerr << "Shared memory " << name << " holds a damaged record; closing" << std::endl;
+            close();
+            return -1;
+        }
+
+        data = rxData + offset + RECORD_HEADER;
+        acquiredBytes = recordSize(length);
+        return int(length);
+    }
+}
+
+void ShmTransport::releaseMessage() {
+    if (!segment || acquiredBytes == 0) {
+        return;
+    }
+    Ring* ring = rxRing;
+    // seq_cst so the store cannot be reordered after the writerWaiting check below
+    ring->tail.store(ring->tail.load(std::memory_order_relaxed) + acquiredBytes, std::memory_order_seq_cst);
+    acquiredBytes = 0;
+
+    if (ring->writerWaiting.load(std::memory_order_seq_cst)) {
+        futexWake(&ring->tail);
+    }
+}
+
+char* ShmTransport::acquireSend(int length) {
+    if (!segment || length < 0) {
+        return nullptr;
+    }
+    Ring* ring = txRing;
+    Uint32 needed = recordSize(Uint32(length));
+    if (needed > txSize / 2) {
+        std::cerr << "Message of " << length << " bytes is too large for shared memory ring" << std::endl;
+        return nullptr;
+    }
+
+    for (;;) {
+        Uint32 head = ring->head.load(std::memory_order_relaxed);
+        Uint32 offset = head & (txSize - 1) & ~7u;
+        Uint32 contiguous = txSize - offset;
+        Uint32 required = contiguous < needed ? contiguous + needed : needed;
+
+        Uint32 size = txSize;
+        auto fits = [ring, head, required, size]() {
+            return size - (head - ring->tail.load(std::memory_order_acquire)) >= required;
+        };
+        while (!fits()) {
+            if (segment->closed.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            waitFor(fits, &ring->tail, &ring->writerWaiting, &segment->closed, CLOSE_POLL_MS);
+        }
+
+        if (contiguous < needed) {
+            // Not enough room before the end of the data area: mark the gap and wrap
+            memcpy(txData + offset, &WRAP_MARKER, sizeof(WRAP_MARKER));
+            ring->head.store(head + contiguous, std::memory_order_release);
+            continue;
+        }
+
+        reservedBytes = needed;
+        return txData + offset + RECORD_HEADER;
+    }
+}
+
+bool ShmTransport::commitSend(int length) {
+    if (!segment || reservedBytes == 0 || recordSize(Uint32(length)) > reservedBytes) {
+        return false;
+    }
+    Ring* ring = txRing;
+    Uint32 head = ring->head.load(std::memory_order_relaxed);
+    char* record = txData + (head & (txSize - 1) & ~7u);
+
+    Uint32 messageLength = Uint32(length);
+    memcpy(record, &messageLength, sizeof(messageLength));
+    record[RECORD_HEADER + length] = '\0';  // Lets readers treat the payload as a C string
+    ring->head.store(head + recordSize(messageLength), std::memory_order_seq_cst);
+    reservedBytes = 0;
+
+    if (ring->readerWaiting.load(std::memory_order_seq_cst)) {
+        futexWake(&ring->head);
+    }
+    return true;
+}
+
+// -------------------------------------------------
+// Copying Transport Interface
+// -------------------------------------------------
+
+int ShmTransport::send(const char* data, int length) {
+    char* slot = acquireSend(length);
+    if (!slot) {
+        return -1;
+    }
+    memcpy(slot, data, length);
+    return commitSend(length) ? length : -1;
+}
+
+int ShmTransport::recv(char* buffer, int maxLength) {
+    char* data;
+    int length;
+    do {
+        length = acquireMessage(data, CLOSE_POLL_MS);
+    } while (length == TIMED_OUT);
+
+    if (length < 0) {
+        return 0;  // Closed, same as an orderly TCP shutdown
+    }
+    int copied = length < maxLength ? length : maxLength;
+    memcpy(buffer, data, copied);
+    releaseMessage();
+    return copied;
+}
+
+bool ShmTransport::canSend(int length) {
+    if (!segment || segment->closed.load(std::memory_order_acquire)) {
+        return true;  // Let the send fail instead of waiting forever
+    }
+    Ring* ring = txRing;
+    Uint32 needed = recordSize(Uint32(length));
+    Uint32 head = ring->head.load(std::memory_order_relaxed);
+    Uint32 contiguous = txSize - (head & (txSize - 1) & ~7u);
+    Uint32 required = contiguous < needed ? contiguous + needed : needed;
+    return txSize - (head - ring->tail.load(std::memory_order_acquire)) >= required;
+}
+
+int ShmTransport::waitReadable(Uint32 timeoutMs) {
+    if (!segment) {
+        return -1;
+    }
+    Ring* ring = rxRing;
+    auto available = [ring]() {
+        return ring->head.load(std::memory_order_acquire) != ring->tail.load(std::memory_order_relaxed);
+    };
+    if (waitFor(available, &ring->head, &ring->readerWaiting, &segment->closed, timeoutMs)) {
+        return 1;
+    }
+    return segment->closed.load(std::memory_order_acquire) ? -1 : 0;
+}
+
+#else  // !__linux__
+
+// Shared memory and futexes are only wired up for Linux; other platforms use TCP.
+
+struct ShmTransport::Ring {};
+struct ShmTransport::Segment {};
+
+ShmTransport* ShmTransport::create(const char* name, Uint32 ringSize) {
+    std::cerr << "Shared memory transport is only available on Linux" << std::endl;
+    return nullptr;
+}
+
+ShmTransport* ShmTransport::attach(const char* name) {
+    std::cerr << "Shared memory transport is only available on Linux" << std::endl;
+    return nullptr;
+}
+
+ShmTransport::~ShmTransport() {}
+bool ShmTransport::map(int fd, size_t size) { return false; }
+bool ShmTransport::bindRings(bool isOwner) { return false; }
+void ShmTransport::close() {}
+bool ShmTransport::canSend(int length) { return true; }
+int ShmTransport::acquireMessage(char*& data, Uint32 timeoutMs) { return -1; }
+void ShmTransport::releaseMessage() {}
+char* ShmTransport::acquireSend(int length) { return nullptr; }
+bool ShmTransport::commitSend(int length) { return false; }
+int ShmTransport::send(const char* data, int length) { return -1; }
+int ShmTransport::recv(char* buffer, int maxLength) { return -1; }
+int ShmTransport::waitReadable(Uint32 timeoutMs) { return -1; }
+
+#endif  // __linux__
@@ -0,0 +1,55 @@
+#ifndef __SHM_TRANSPORT_H__
+#define __SHM_TRANSPORT_H__
+
+#include "Transport.h"
+#include <string>
+
+// ShmTransport: shared-memory transport for a server, bots and recorders on the same machine.
+// A /dev/shm segment holds one single-producer/single-consumer ring per direction.
+// Messages are written and read in place, and a reader that finds its ring empty
+// spins briefly and then sleeps on a futex until the writer publishes.
+// Only available on Linux; elsewhere create/attach report an error and return nullptr.
+class ShmTransport : public Transport {
+private:
+    struct Ring;
+    struct Segment;
+
+    Segment* segment = nullptr;  // Mapped shared segment
+    size_t mappedSize = 0;       // Size of the mapping in bytes
+    Ring* rxRing = nullptr;      // Ring this side reads from
+    Ring* txRing = nullptr;      // Ring this side writes to
+    char* rxData = nullptr;      // Data area of the read ring
+    char* txData = nullptr;      // Data area of the write ring
+    Uint32 rxSize = 0;           // Data area sizes, as checked when the rings were bound
+    Uint32 txSize = 0;
+    bool owner = false;          // True if this side created (and will unlink) the segment
+    std::string name;            // Segment name, e.g. "/pong-local"
+    Uint32 acquiredBytes = 0;    // Ring bytes held by the message handed out by acquireMessage
+    Uint32 reservedBytes = 0;    // Ring bytes reserved by acquireSend
+
+    ShmTransport() {}
+    bool map(int fd, size_t size);
+    bool bindRings(bool isOwner);  // False if the segment's ring layout does not fit the mapping
+
+public:
+    ~ShmTransport();
+
+    static const Uint32 DEFAULT_RING_SIZE = 1 << 20;  // 1 MiB per direction
+
+    static ShmTransport* create(const char* name, Uint32 ringSize = DEFAULT_RING_SIZE);  // Host side: creates the segment
+    static ShmTransport* attach(const char* name);  // Peer side: maps an existing segment
+
+    int send(const char* data, int length) override;
+    int recv(char* buffer, int maxLength) override;
+    int waitReadable(Uint32 timeoutMs) override;
+    bool isMessageOriented() const override { return true; }
+    void close() override;
+    bool canSend(int length) override;
+
+    int acquireMessage(char*& data, Uint32 timeoutMs) override;
+    void releaseMessage() override;
+    char* acquireSend(int length) override;
+    bool commitSend(int length) override;
+};
+
+#endif  // __SHM_TRANSPORT_H__
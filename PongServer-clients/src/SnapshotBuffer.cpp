@@ -0,0 +1,111 @@
+#include "SnapshotBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+static const double INTERVAL_GAIN = 1.0 / 16;  // Smoothing of the mean interval and jitter (RFC 3550 style)
+static const double DELAY_RAISE_GAIN = 0.25;   // Raise the delay quickly when jitter grows...
+static const double DELAY_DROP_GAIN = 0.01;    // ...and lower it slowly so playback does not lurch
+static const float TELEPORT_DISTANCE = 100;     // Ball jumps larger than this (recentring) are not smoothed
+
+SnapshotBuffer::SnapshotBuffer() {
+    interpDelay = minDelayMs;
+}
+
+Snapshot SnapshotBuffer::lerp(const Snapshot& a, const Snapshot& b, double t) {
+    Snapshot s;
+    s.time = a.time + (b.time - a.time) * t;
+    s.player1X = (float)(a.player1X + (b.player1X - a.player1X) * t);
+    s.player1Y = (float)(a.player1Y + (b.player1Y - a.player1Y) * t);
+    s.player2X = (float)(a.player2X + (b.player2X - a.player2X) * t);
+    s.player2Y = (float)(a.player2Y + (b.player2Y - a.player2Y) * t);
+    s.ballX = (float)(a.ballX + (b.ballX - a.ballX) * t);
+    s.ballY = (float)(a.ballY + (b.ballY - a.ballY) * t);
+
+    if (std::fabs(b.ballX - a.ballX) > TELEPORT_DISTANCE || std::fabs(b.ballY - a.ballY) > TELEPORT_DISTANCE) {
+        const Snapshot& nearest = t < 0.5 ? a : b;
+        s.ballX = nearest.ballX;
+        s.ballY = nearest.ballY;
+    }
+    return s;
+}
+
+void SnapshotBuffer::push(const Snapshot& snapshot, double arrivalTime) {
+    if (!snapshots.empty() && snapshot.time <= snapshots.back().time) {
+        return;  // Stale or duplicate
+    }
+
+    // Track how irregularly snapshots arrive compared with how they were sent
+    double transit = arrivalTime - snapshot.time;
+    if (lastTime >= 0) {
+        double interval = snapshot.time - lastTime;
+        if (meanInterval == 0) {
+            meanInterval = interval;
+        }
+        meanInterval += (interval - meanInterval) * INTERVAL_GAIN;
+
+        bool serverStamped = arrivalTime != snapshot.time;
+        double sentSpacing = serverStamped ? interval : meanInterval;
+        double deviation = std::fabs((arrivalTime - lastArrival) - sentSpacing);
+        jitter += (deviation - jitter) * INTERVAL_GAIN;
+        meanTransit += (transit - meanTransit) * INTERVAL_GAIN;
+    }
+    else {
+        meanTransit = transit;
+    }
+    lastTime = snapshot.time;
+    lastArrival = arrivalTime;
+
+    // Adapt the render delay toward the jitter target
+    double buffering = std::min(maxDelayMs, std::max(minDelayMs, meanInterval + jitterMultiplier * jitter));
+    double target = meanTransit + buffering;
+    interpDelay += (target - interpDelay) * (target > interpDelay ? DELAY_RAISE_GAIN : DELAY_DROP_GAIN);
+
+    snapshots.push_back(snapshot);
+    if ((int)snapshots.size() > MAX_SNAPSHOTS) {
+        snapshots.pop_front();
+    }
+}
+
+bool SnapshotBuffer::sample(double now, Snapshot& out) {
+    if (snapshots.empty()) {
+        return false;
+    }
+
+    double renderTime = now - interpDelay;
+
+    // Drop snapshots that can no longer bracket the render time
+    while (snapshots.size() > 2 && snapshots[1].time <= renderTime) {
+        snapshots.pop_front();
+    }
+
+    const Snapshot& oldest = snapshots.front();
+    if (renderTime <= oldest.time || snapshots.size() == 1) {
+        out = oldest;
+        return true;
+    }
+
+    const Snapshot& a = snapshots[0];
+    const Snapshot& b = snapshots[1];
+    if (renderTime <= b.time) {
+        out = lerp(a, b, (renderTime - a.time) / (b.time - a.time));
+        return true;
+    }
+
+    // Buffer ran dry: continue the last motion for a limited time, then hold
+    double ahead = renderTime - b.time;
+    if (ahead > maxExtrapolationMs) {
+        ahead = maxExtrapolationMs;
+        heldSamples++;
+    }
+    else {
+        extrapolatedSamples++;
+    }
+    out = lerp(a, b, 1.0 + ahead / (b.time - a.time));
+    return true;
+}
+
+void SnapshotBuffer::clear() {
+    snapshots.clear();
+    lastTime = -1;
+    lastArrival = -1;
+}
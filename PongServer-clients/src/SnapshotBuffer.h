@@ -0,0 +1,64 @@
+#ifndef __SNAPSHOT_BUFFER_H__
+#define __SNAPSHOT_BUFFER_H__
+
+#include <deque>
+
+// Snapshot: positions from one GAME_DATA message, stamped with the time it was taken
+struct Snapshot {
+    double time = 0;  // Timestamp in ms: the server's time on the local clock, or the arrival time
+    float player1X = 0;
+    float player1Y = 0;
+    float player2X = 0;
+    float player2Y = 0;
+    float ballX = 0;
+    float ballY = 0;
+};
+
+// SnapshotBuffer: jitter buffer for server snapshots.
+// The scene is drawn interpDelay ms in the past, interpolating linearly between the two
+// snapshots either side of that time. interpDelay follows the measured transit time and
+// jitter so a late snapshot is normally already buffered when it is needed; if the buffer
+// runs dry the last motion is extrapolated for at most maxExtrapolationMs, then held.
+// Snapshots stamped with the server's time give the true send spacing; without a clock
+// estimate they are stamped on arrival and the spacing is taken as the mean interval.
+class SnapshotBuffer {
+private:
+    std::deque<Snapshot> snapshots;  // Ordered by time, oldest first
+
+    double interpDelay;        // Current render delay behind the newest snapshot time (ms)
+    double meanInterval = 0;   // Smoothed time between snapshots (ms)
+    double jitter = 0;         // Smoothed variation in transit time between snapshots (ms)
+    double meanTransit = 0;    // Smoothed arrival time minus snapshot time (ms)
+    double lastTime = -1;      // Timestamp of the previous snapshot
+    double lastArrival = -1;   // Arrival time of the previous snapshot
+
+    int extrapolatedSamples = 0;  // Samples taken beyond the newest snapshot
+    int heldSamples = 0;          // Samples clamped because extrapolation ran out
+
+    static Snapshot lerp(const Snapshot& a, const Snapshot& b, double t);
+
+public:
+    static const int MAX_SNAPSHOTS = 64;
+
+    double minDelayMs = 20;            // Never render closer than this to the newest snapshot
+    double maxDelayMs = 250;           // Never buffer more than this
+    double jitterMultiplier = 3;       // Delay target = transit + mean interval + jitterMultiplier * jitter
+    double maxExtrapolationMs = 100;   // How far past the newest snapshot motion may be continued
+
+    SnapshotBuffer();
+
+    void push(const Snapshot& snapshot, double arrivalTime);  // Add a snapshot; updates the jitter estimate
+    void push(const Snapshot& snapshot) { push(snapshot, snapshot.time); }  // Snapshot stamped on arrival
+    bool sample(double now, Snapshot& out);  // Fill `out` with the state at now - interpDelay; false if empty
+    void clear();
+
+    double getInterpDelay() const { return interpDelay; }
+    double getJitter() const { return jitter; }
+    double getMeanInterval() const { return meanInterval; }
+    double getMeanTransit() const { return meanTransit; }
+    int getExtrapolatedSamples() const { return extrapolatedSamples; }
+    int getHeldSamples() const { return heldSamples; }
+    int size() const { return (int)snapshots.size(); }
+};
+
+#endif  // __SNAPSHOT_BUFFER_H__
@@ -0,0 +1,86 @@
+#include "SoundPlayer.h"
+#include "Timing.h"
+#include <algorithm>
+#include <iostream>
+
+bool SoundPlayer::attach() {
+    int rate, channels;
+    Uint16 format;
+    if (Mix_QuerySpec(&rate, &format, &channels) == 0) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        frequency = rate;
+        frameBytes = SDL_AUDIO_BITSIZE(format) / 8 * channels;
+        attached = true;
+    }
+    Mix_SetPostMix(postMix, this);
+    return true;
+}
+
+void SoundPlayer::detach() {
+    if (attached) {
+        Mix_SetPostMix(nullptr, nullptr);  // Waits for a running callback to finish
+        std::lock_guard<std::mutex> lock(mutex);
+        attached = false;
+        started.clear();
+    }
+}
+
+void SDLCALL SoundPlayer::postMix(void* self, Uint8*, int length) {
+    SoundPlayer* player = (SoundPlayer*)self;
+    double now = nowMs();
+    std::lock_guard<std::mutex> lock(player->mutex);
+
+    // The mixer does not report its buffer size, but each callback is one buffer.
+    // This buffer holds the start of every sound played since the last one
+    if (player->frequency > 0 && player->frameBytes > 0) {
+        player->bufferMs = 1000.0 * length / player->frameBytes / player->frequency;
+    }
+    for (double eventTime : player->started) {
+        double latency = now - eventTime + player->bufferMs;
+        player->totalMs += latency;
+        player->maxMs = std::max(player->maxMs, latency);
+        player->sounds++;
+    }
+    player->started.clear();
+}
+
+void SoundPlayer::play(Mix_Chunk* chunk, double eventTime) {
+    if (!chunk) {
+        return;
+    }
+    // Play first: the mixer takes the audio lock, which the post-mix callback runs under
+    if (Mix_PlayChannel(-1, chunk, 0) < 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (attached) {
+        started.push_back(eventTime);
+    }
+}
+
+AudioLatencyStats SoundPlayer::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    AudioLatencyStats stats;
+    stats.meanMs = sounds > 0 ? totalMs / sounds : 0;
+    stats.maxMs = maxMs;
+    stats.bufferMs = bufferMs;
+    stats.frequency = frequency;
+    stats.sounds = sounds;
+    return stats;
+}
+
+void SoundPlayer::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    totalMs = 0;
+    maxMs = 0;
+    sounds = 0;
+}
+
+void SoundPlayer::printStats() {
+    AudioLatencyStats stats = getStats();
+    std::cout << "Audio: " << stats.frequency << " Hz, " << stats.bufferMs << " ms buffer, event to audio " << stats.meanMs
+              << " ms mean (max " << stats.maxMs << " ms) over " << stats.sounds << " sounds" << std::endl;
+}
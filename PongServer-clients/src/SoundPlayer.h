@@ -0,0 +1,50 @@
+#ifndef __SOUND_PLAYER_H__
+#define __SOUND_PLAYER_H__
+
+#include <mutex>
+#include <vector>
+#include "SDL.h"
+#include "SDL_mixer.h"
+
+// AudioLatencyStats: event-to-audio latency of the sounds played since the last reset (ms)
+struct AudioLatencyStats {
+    double meanMs = 0;    // Event known to its buffer leaving the device, on average
+    double maxMs = 0;
+    double bufferMs = 0;  // One device buffer, included in the figures above
+    int frequency = 0;    // Rate the device runs at (Hz)
+    int sounds = 0;       // Sounds measured
+};
+
+// SoundPlayer: starts effects the moment their event is known and measures how long each
+// takes to reach the audio device. play() stamps the sound with its event time; the mixer's
+// post-mix callback, which runs on the audio thread as each buffer is handed to the device,
+// closes out every sound started before it. A sound is heard once that buffer has played,
+// so one buffer period is added: the result is event-to-speaker time, less whatever
+// latency the driver adds below SDL.
+class SoundPlayer {
+private:
+    std::mutex mutex;                // Guards everything below; never held while calling the mixer
+    std::vector<double> started;     // Event times of sounds not yet mixed (nowMs())
+    double totalMs = 0;
+    double maxMs = 0;
+    int sounds = 0;
+    double bufferMs = 0;
+    int frequency = 0;
+    int frameBytes = 0;              // Bytes per sample frame on the device
+    bool attached = false;
+
+    static void SDLCALL postMix(void* self, Uint8* stream, int length);
+
+public:
+    ~SoundPlayer() { detach(); }
+
+    bool attach();  // After the mixer is open: read its format and start measuring
+    void detach();
+    void play(Mix_Chunk* chunk, double eventTime);  // eventTime: nowMs() when the event happened or arrived
+
+    AudioLatencyStats getStats();
+    void resetStats();
+    void printStats();
+};
+
+#endif  // __SOUND_PLAYER_H__
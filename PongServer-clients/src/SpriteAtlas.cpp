@@ -0,0 +1,99 @@
+#include "SpriteAtlas.h"
+#include <algorithm>
+#include <iostream>
+
+void SpriteAtlas::add(const std::string& name, SDL_Surface* surface) {
+    if (surface) {
+        pending.push_back({ name, surface });
+    }
+}
+
+bool SpriteAtlas::build(SDL_Renderer* renderer) {
+    destroy();
+
+    int limit = maxWidth;
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.max_texture_width > 0) {
+        limit = std::min(limit, info.max_texture_width);
+    }
+
+    // Shelf packing: tallest images first, each shelf as tall as its first image
+    std::vector<size_t> order(pending.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return pending[a].surface->h > pending[b].surface->h;
+    });
+
+    std::vector<SDL_Rect> placed(pending.size());
+    int x = 0, y = 0, shelfHeight = 0, width = 0;
+    for (size_t i : order) {
+        SDL_Surface* surface = pending[i].surface;
+        if (x > 0 && x + surface->w > limit) {
+            x = 0;
+            y += shelfHeight + padding;
+            shelfHeight = 0;
+        }
+        placed[i] = { x, y, surface->w, surface->h };
+        x += surface->w + padding;
+        shelfHeight = std::max(shelfHeight, surface->h);
+        width = std::max(width, x - padding);
+    }
+    int height = y + shelfHeight;
+
+    SDL_Surface* atlas = nullptr;
+    if (width > 0 && height > 0) {
+        atlas = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!atlas) {
+            std::cerr << "Failed to create atlas surface: " << SDL_GetError() << std::endl;
+        }
+    }
+    for (size_t i = 0; i < pending.size(); i++) {
+        if (atlas) {
+            SDL_SetSurfaceBlendMode(pending[i].surface, SDL_BLENDMODE_NONE);  // Copy alpha as it is
+            SDL_BlitSurface(pending[i].surface, nullptr, atlas, &placed[i]);
+        }
+        SDL_FreeSurface(pending[i].surface);
+    }
+    if (!atlas) {
+        pending.clear();
+        return false;
+    }
+
+    texture = SDL_CreateTextureFromSurface(renderer, atlas);
+    SDL_FreeSurface(atlas);
+    if (!texture) {
+        std::cerr << "Failed to create atlas texture (" << width << "x" << height << "): " << SDL_GetError() << std::endl;
+        pending.clear();
+        return false;
+    }
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        Sprite sprite;
+        sprite.texture = texture;
+        sprite.source = placed[i];
+        names.push_back(pending[i].name);
+        sprites.push_back(sprite);
+    }
+    pending.clear();
+    return true;
+}
+
+void SpriteAtlas::destroy() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    names.clear();
+    sprites.clear();
+}
+
+Sprite SpriteAtlas::find(const std::string& name) const {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name) {
+            return sprites[i];
+        }
+    }
+    return Sprite();
+}
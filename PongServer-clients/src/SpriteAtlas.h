@@ -0,0 +1,46 @@
+#ifndef __SPRITE_ATLAS_H__
+#define __SPRITE_ATLAS_H__
+
+#include <string>
+#include <vector>
+#include "SDL.h"
+
+// Sprite: a region of an atlas texture
+struct Sprite {
+    SDL_Texture* texture = nullptr;
+    SDL_Rect source = { 0, 0, 0, 0 };
+
+    bool isValid() const { return texture != nullptr; }
+};
+
+// SpriteAtlas: packs separately loaded images into one texture at load time.
+// Images are placed on shelves, tallest first, within the renderer's maximum texture width,
+// with a gap between them so scaled sprites never sample their neighbours. Everything drawn
+// from the atlas shares one texture, which lets a SpriteBatch submit it in a single run.
+class SpriteAtlas {
+private:
+    struct Pending {
+        std::string name;
+        SDL_Surface* surface;
+    };
+
+    std::vector<Pending> pending;          // Images added since the last build
+    std::vector<std::string> names;        // Sprite names, parallel to sprites
+    std::vector<Sprite> sprites;
+    SDL_Texture* texture = nullptr;
+
+public:
+    int padding = 2;        // Pixels left between packed images
+    int maxWidth = 4096;    // Widest atlas to build, further limited by the renderer
+
+    ~SpriteAtlas() { destroy(); }
+
+    void add(const std::string& name, SDL_Surface* surface);  // Takes ownership of the surface
+    bool build(SDL_Renderer* renderer);  // Pack everything added into the atlas texture
+    void destroy();
+
+    Sprite find(const std::string& name) const;  // Invalid sprite if the name was never packed
+    SDL_Texture* getTexture() const { return texture; }
+};
+
+#endif  // __SPRITE_ATLAS_H__
@@ -0,0 +1,77 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+void SpriteBatch::begin() {
+    items.clear();
+}
+
+void SpriteBatch::add(const Sprite& sprite, const SDL_Rect& target, int layer) {
+    if (sprite.isValid()) {
+        items.push_back({ layer, sprite.texture, sprite.source, target });
+    }
+}
+
+void SpriteBatch::flush(SDL_Renderer* renderer) {
+    drawCalls = 0;
+    std::stable_sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        if (a.layer != b.layer) {
+            return a.layer < b.layer;
+        }
+        return a.texture < b.texture;
+    });
+
+    // Neighbours with the same texture are drawn together even across a layer change, which
+    // keeps their order
+    size_t start = 0;
+    for (size_t i = 1; i <= items.size(); i++) {
+        if (i == items.size() || items[i].texture != items[start].texture) {
+            submit(renderer, &items[start], i - start);
+            start = i;
+        }
+    }
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+
+void SpriteBatch::submit(SDL_Renderer* renderer, const Item* first, size_t count) {
+    int textureW, textureH;
+    SDL_QueryTexture(first->texture, nullptr, nullptr, &textureW, &textureH);
+
+    // Two triangles per sprite, sharing the quad's corners
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    vertices.reserve(count * 4);
+    indices.reserve(count * 6);
+    const SDL_Color white = { 255, 255, 255, 255 };
+    for (size_t i = 0; i < count; i++) {
+        const SDL_Rect& src = first[i].source;
+        const SDL_Rect& dst = first[i].target;
+        float u0 = (float)src.x / textureW, u1 = (float)(src.x + src.w) / textureW;
+        float v0 = (float)src.y / textureH, v1 = (float)(src.y + src.h) / textureH;
+        float x0 = (float)dst.x, x1 = (float)(dst.x + dst.w);
+        float y0 = (float)dst.y, y1 = (float)(dst.y + dst.h);
+
+        int base = (int)vertices.size();
+        vertices.push_back({ { x0, y0 }, white, { u0, v0 } });
+        vertices.push_back({ { x1, y0 }, white, { u1, v0 } });
+        vertices.push_back({ { x1, y1 }, white, { u1, v1 } });
+        vertices.push_back({ { x0, y1 }, white, { u0, v1 } });
+        const int quad[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int corner : quad) {
+            indices.push_back(base + corner);
+        }
+    }
+    SDL_RenderGeometry(renderer, first->texture, vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size());
+    drawCalls++;
+}
+
+#else
+
+void SpriteBatch::submit(SDL_Renderer* renderer, const Item* first, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        SDL_RenderCopy(renderer, first[i].texture, &first[i].source, &first[i].target);
+        drawCalls++;
+    }
+}
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef __SPRITE_BATCH_H__
+#define __SPRITE_BATCH_H__
+
+#include <vector>
+#include "SDL.h"
+#include "SpriteAtlas.h"
+
+// SpriteBatch: collects a frame's sprites and submits them grouped by texture.
+// Sprites are sorted by layer, then by texture, keeping submission order within both, so
+// anything on a higher layer is still drawn on top. With SDL 2.0.18 or newer each run of
+// sprites sharing a texture is one SDL_RenderGeometry call; older SDL (the bundled 2.0.9)
+// falls back to one SDL_RenderCopy per sprite, still in texture order.
+class SpriteBatch {
+private:
+    struct Item {
+        int layer;
+        SDL_Texture* texture;
+        SDL_Rect source;
+        SDL_Rect target;
+    };
+
+    std::vector<Item> items;
+    int drawCalls = 0;  // Calls made by the last flush
+
+    void submit(SDL_Renderer* renderer, const Item* first, size_t count);  // One run of a single texture
+
+public:
+    void begin();
+    void add(const Sprite& sprite, const SDL_Rect& target, int layer = 0);
+    void flush(SDL_Renderer* renderer);  // Draw everything added since begin()
+
+    int getSpriteCount() const { return (int)items.size(); }
+    int getDrawCalls() const { return drawCalls; }
+};
+
+#endif  // __SPRITE_BATCH_H__
@@ -0,0 +1,49 @@
+#include "StartupTimeline.h"
+#include "Timing.h"
+#include <algorithm>
+#include <iostream>
+
+void StartupTimeline::begin() {
+    std::lock_guard<std::mutex> lock(mutex);
+    startedAt = nowMs();
+    stages.clear();
+}
+
+void StartupTimeline::mark(const std::string& stage, double tookMs) {
+    double now = nowMs();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const Stage& existing : stages) {
+        if (existing.name == stage) {
+            return;
+        }
+    }
+    stages.push_back({ stage, now - startedAt, tookMs });
+}
+
+bool StartupTimeline::has(const std::string& stage) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const Stage& existing : stages) {
+        if (existing.name == stage) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void StartupTimeline::print() const {
+    std::vector<Stage> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = stages;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Stage& a, const Stage& b) { return a.finishedMs < b.finishedMs; });
+
+    std::cout << "Startup timeline (ms since launch):" << std::endl;
+    for (const Stage& stage : sorted) {
+        std::cout << "  " << stage.finishedMs << "  " << stage.name;
+        if (stage.tookMs >= 0) {
+            std::cout << " (" << stage.tookMs << " ms)";
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef __STARTUP_TIMELINE_H__
+#define __STARTUP_TIMELINE_H__
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+// StartupTimeline: when each startup stage finished, measured from begin(), for the
+// time-to-first-frame breakdown. Stages run on different threads and overlap, so each mark
+// records both when it finished and, where known, how long the stage itself took.
+// mark() may be called from any thread; only the first mark of each stage is kept.
+class StartupTimeline {
+private:
+    struct Stage {
+        std::string name;
+        double finishedMs;  // Since begin()
+        double tookMs;      // Duration of the stage itself, or -1 if it has none of its own
+    };
+
+    mutable std::mutex mutex;
+    double startedAt = 0;
+    std::vector<Stage> stages;  // In the order they were marked
+
+public:
+    void begin();  // Start the clock (process start)
+    void mark(const std::string& stage, double tookMs = -1);
+    bool has(const std::string& stage) const;
+    void print() const;
+};
+
+#endif  // __STARTUP_TIMELINE_H__
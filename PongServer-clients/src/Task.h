@@ -0,0 +1,136 @@
+#ifndef __TASK_H__
+#define __TASK_H__
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// Task<T>: a lazily started coroutine that produces a T.
+// Awaiting a task starts it and resumes the awaiting coroutine when it finishes;
+// tasks that nobody awaits are handed to EventLoop::spawn.
+template <typename T = void>
+class Task;
+
+namespace task_detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;  // Coroutine to resume when this one finishes
+    std::exception_ptr exception;          // Exception thrown by the coroutine body
+
+    // Resume whoever awaited us (symmetric transfer), or return to the event loop
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> next = handle.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    T value{};
+
+    Task<T> get_return_object();
+    void return_value(T v) { value = std::move(v); }
+    T result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+    void result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+}  // namespace task_detail
+
+template <typename T>
+class Task {
+public:
+    using promise_type = task_detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+private:
+    Handle handle;
+
+public:
+    Task() : handle(nullptr) {}
+    explicit Task(Handle handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    bool valid() const { return handle != nullptr; }
+    bool done() const { return !handle || handle.done(); }
+    Handle getHandle() const { return handle; }
+
+    // Rethrows an exception that escaped the coroutine body
+    void rethrowIfFailed() const {
+        if (handle && handle.promise().exception) {
+            std::rethrow_exception(handle.promise().exception);
+        }
+    }
+
+    // co_await task: start the child and resume the parent when it completes
+    struct Awaiter {
+        Handle handle;
+
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        T await_resume() { return handle.promise().result(); }
+    };
+
+    Awaiter operator co_await() const& noexcept { return Awaiter{ handle }; }
+};
+
+namespace task_detail {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+}  // namespace task_detail
+
+#endif  // __TASK_H__
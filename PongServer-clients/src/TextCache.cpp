@@ -0,0 +1,47 @@
+#include "TextCache.h"
+#include <iostream>
+
+void TextCache::draw(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Rect& rect) {
+    Entry& entry = entries[std::make_pair(font, text)];
+    entry.lastUsed = frame;
+
+    if (!entry.texture) {
+        SDL_Surface* textSurface = TTF_RenderText_Solid(font, text.c_str(), colour);
+        if (!textSurface) {
+            std::cerr << "Failed to create text surface: " << TTF_GetError() << std::endl;
+            return;
+        }
+        entry.texture = SDL_CreateTextureFromSurface(renderer, textSurface);
+        SDL_FreeSurface(textSurface);
+        if (!entry.texture) {
+            std::cerr << "Failed to create text texture: " << SDL_GetError() << std::endl;
+            return;
+        }
+        SDL_QueryTexture(entry.texture, NULL, NULL, &entry.w, &entry.h);
+        uploads++;
+    }
+
+    rect.w = entry.w;
+    rect.h = entry.h;
+    SDL_RenderCopy(renderer, entry.texture, NULL, &rect);
+}
+
+void TextCache::endFrame() {
+    frame++;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (frame - it->second.lastUsed > EVICT_AFTER_FRAMES) {
+            SDL_DestroyTexture(it->second.texture);
+            it = entries.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void TextCache::clear() {
+    for (auto& entry : entries) {
+        SDL_DestroyTexture(entry.second.texture);
+    }
+    entries.clear();
+}
@@ -0,0 +1,42 @@
+#ifndef __TEXT_CACHE_H__
+#define __TEXT_CACHE_H__
+
+#include <map>
+#include <string>
+#include <utility>
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+// TextCache: textures of rendered strings, keyed by font and text.
+// A string is rendered and uploaded the first time it is drawn and reused while it stays the
+// same, so labels that change every few seconds cost one upload per change instead of one per
+// frame. Entries unused for EVICT_AFTER_FRAMES frames are destroyed.
+class TextCache {
+private:
+    struct Entry {
+        SDL_Texture* texture = nullptr;
+        int w = 0;
+        int h = 0;
+        Uint32 lastUsed = 0;  // Frame the entry was last drawn in
+    };
+
+    static const Uint32 EVICT_AFTER_FRAMES = 600;  // ~10 s at 60 fps
+
+    std::map<std::pair<TTF_Font*, std::string>, Entry> entries;
+    Uint32 frame = 0;
+    int uploads = 0;  // Textures created so far
+
+public:
+    SDL_Color colour = { 255, 255, 255, 255 };
+
+    ~TextCache() { clear(); }
+
+    void draw(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Rect& rect);  // Sets rect.w and rect.h
+    void endFrame();  // Evict entries that have not been drawn for a while
+    void clear();
+
+    int getUploads() const { return uploads; }
+    int size() const { return (int)entries.size(); }
+};
+
+#endif  // __TEXT_CACHE_H__
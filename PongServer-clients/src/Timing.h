@@ -0,0 +1,12 @@
+#ifndef __TIMING_H__
+#define __TIMING_H__
+
+#include "SDL.h"
+
+// High-resolution monotonic time in milliseconds
+inline double nowMs() {
+    static const double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0;
+    return SDL_GetPerformanceCounter() / ticksPerMs;
+}
+
+#endif  // __TIMING_H__
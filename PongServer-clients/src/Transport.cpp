@@ -0,0 +1,142 @@
+#include "Transport.h"
+#include <iostream>
+
+// -------------------------------------------------
+// TcpTransport
+// -------------------------------------------------
+
+TcpTransport::TcpTransport(SocketHandle socket) : socket(socket) {}
+
+TcpTransport::~TcpTransport() {
+    close();
+}
+
+// Resolve the host and open a TCP connection to it
+TcpTransport* TcpTransport::connect(const char* host, Uint16 port) {
+    IPaddress ip;
+    if (SDLNet_ResolveHost(&ip, host, port) == -1) {
+        std::cerr << "SDLNet_ResolveHost: " << SDLNet_GetError() << std::endl;
+        return nullptr;
+    }
+
+    SocketHandle socket = socketConnect(ip);
+    if (socket == NO_SOCKET) {
+        std::cerr << "Could not connect to " << host << ":" << port << std::endl;
+        return nullptr;
+    }
+
+    return new TcpTransport(socket);
+}
+
+int TcpTransport::waitFor(int events, Uint32 timeoutMs) {
+    SocketPoller poller;
+    poller.add(socket, events);
+    int ready = poller.wait(timeoutMs);
+    return ready > 0 ? poller.ready(0) : ready;
+}
+
+// Without a send queue, waits until all of it is taken, as SDLNet_TCP_Send did
+int TcpTransport::send(const char* data, int length) {
+    int sent = 0;
+    if (sendQueueLimit > 0) {
+        // Anything already queued goes first, so only an empty queue lets data skip it
+        if (flushSendQueue() < 0) {
+            return -1;
+        }
+        if (queuedBytes() == 0) {
+            sent = socketSend(socket, data, length);
+            if (sent == SOCKET_WOULD_BLOCK) {
+                sent = 0;
+            }
+            else if (sent < 0) {
+                return -1;
+            }
+        }
+        if (queuedBytes() + length - sent > sendQueueLimit) {
+            return -1;  // Should have asked canSend first
+        }
+        sendQueue.insert(sendQueue.end(), data + sent, data + length);
+        return length;
+    }
+
+    while (sent < length) {
+        if (socket == NO_SOCKET) {
+            return -1;
+        }
+        int result = socketSend(socket, data + sent, length - sent);
+        if (result == SOCKET_WOULD_BLOCK) {
+            if (waitFor(SocketPoller::WRITE, SocketPoller::FOREVER) < 0) {
+                return -1;
+            }
+        } else if (result < 0) {
+            return -1;
+        } else {
+            sent += result;
+        }
+    }
+    return sent;
+}
+
+bool TcpTransport::canSend(int length) {
+    if (sendQueueLimit == 0) {
+        return true;
+    }
+    if (queuedBytes() + length > sendQueueLimit) {
+        flushSendQueue();  // The socket may have taken some since
+    }
+    return socket != NO_SOCKET && queuedBytes() + length <= sendQueueLimit;
+}
+
+int TcpTransport::flushSendQueue() {
+    while (queuedBytes() > 0) {
+        if (socket == NO_SOCKET) {
+            return -1;
+        }
+        int sent = socketSend(socket, sendQueue.data() + sendQueueStart, queuedBytes());
+        if (sent == SOCKET_WOULD_BLOCK) {
+            break;
+        }
+        if (sent < 0) {
+            return -1;
+        }
+        sendQueueStart += sent;
+    }
+    if (sendQueueStart == sendQueue.size()) {
+        sendQueue.clear();
+        sendQueueStart = 0;
+    }
+    else if (sendQueueStart > sendQueue.size() / 2) {
+        sendQueue.erase(sendQueue.begin(), sendQueue.begin() + sendQueueStart);  // Keep the copy shorter than what was sent
+        sendQueueStart = 0;
+    }
+    return queuedBytes();
+}
+
+int TcpTransport::recv(char* buffer, int maxLength) {
+    while (socket != NO_SOCKET) {
+        int received = socketRecv(socket, buffer, maxLength);
+        if (received != SOCKET_WOULD_BLOCK) {
+            return received;
+        }
+        if (waitFor(SocketPoller::READ, SocketPoller::FOREVER) < 0) {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+int TcpTransport::waitReadable(Uint32 timeoutMs) {
+    if (socket == NO_SOCKET) {
+        return -1;
+    }
+    int ready = waitFor(SocketPoller::READ, timeoutMs);
+    if (ready < 0) {
+        return -1;
+    }
+    return (ready & SocketPoller::READ) ? 1 : 0;
+}
+
+void TcpTransport::close() {
+    socketClose(socket);
+    socket = NO_SOCKET;
+}
@@ -0,0 +1,72 @@
+#ifndef __TRANSPORT_H__
+#define __TRANSPORT_H__
+
+#include "NativeSocket.h"
+#include <vector>
+
+// Transport: moves raw bytes between the client and its peer.
+// TCP is a byte stream; shared memory delivers whole messages, which lets the
+// channel skip its framing stage and read messages in place.
+class Transport {
+public:
+    virtual ~Transport() {}
+
+    static const int TIMED_OUT = -2;  // Returned by acquireMessage when nothing arrived in time
+
+    virtual int send(const char* data, int length) = 0;  // Returns bytes sent, or -1 on error
+    virtual int recv(char* buffer, int maxLength) = 0;  // Blocks; returns bytes received, 0 on close, -1 on error
+    virtual int waitReadable(Uint32 timeoutMs) = 0;  // Returns 1 if data is waiting, 0 on timeout, -1 on error
+    virtual bool isMessageOriented() const = 0;  // True if every recv returns exactly one whole message
+    // Closes the connection. ShmTransport also wakes a reader blocked in recv; TcpTransport frees
+    // the socket, so it must not be closed while another thread may be reading from it
+    virtual void close() = 0;
+    // False if send would block for lack of space. Shared memory and TCP with a send queue can
+    // tell; otherwise this says true and send may still block
+    virtual bool canSend(int length) { return true; }
+    virtual SocketHandle nativeSocket() { return NO_SOCKET; }  // Socket an event loop can wait on, if any
+    // Makes send never block: what the socket cannot take at once is queued, up to `bytes`, and
+    // written by later sends or flushSendQueue. Only TCP has this; shared memory never blocks
+    virtual void setSendQueueLimit(int bytes) {}
+    virtual int flushSendQueue() { return 0; }  // Writes what it can of the queue; returns the bytes left, or -1 on error
+
+    // Zero-copy access for message-oriented transports. acquireMessage hands out
+    // the next message in place (valid until releaseMessage) and returns its length,
+    // -1 on close or TIMED_OUT. acquireSend reserves space for an outgoing message
+    // that becomes visible to the peer on commitSend.
+    virtual int acquireMessage(char*& data, Uint32 timeoutMs) { return -1; }
+    virtual void releaseMessage() {}
+    virtual char* acquireSend(int length) { return nullptr; }
+    virtual bool commitSend(int length) { return false; }
+};
+
+// TcpTransport: a native TCP socket (see NativeSocket.h). The socket itself never blocks;
+// recv waits for it as the interface requires, and so does send unless it has a send queue
+class TcpTransport : public Transport {
+private:
+    SocketHandle socket = NO_SOCKET;
+    int sendQueueLimit = 0;        // 0 = send waits until everything is written
+    std::vector<char> sendQueue;   // Bytes taken by send but not yet by the socket
+    size_t sendQueueStart = 0;     // Already written from the front of sendQueue
+
+    int queuedBytes() const { return (int)(sendQueue.size() - sendQueueStart); }
+
+    int waitFor(int events, Uint32 timeoutMs);  // SocketPoller bits, 0 on timeout, -1 on error
+
+public:
+    explicit TcpTransport(SocketHandle socket);  // Takes over a socket from socketConnect or socketAccept
+    ~TcpTransport();
+
+    static TcpTransport* connect(const char* host, Uint16 port);  // Returns nullptr on failure
+
+    int send(const char* data, int length) override;
+    int recv(char* buffer, int maxLength) override;
+    int waitReadable(Uint32 timeoutMs) override;
+    bool isMessageOriented() const override { return false; }
+    void close() override;
+    bool canSend(int length) override;
+    SocketHandle nativeSocket() override { return socket; }
+    void setSendQueueLimit(int bytes) override { sendQueueLimit = bytes; }
+    int flushSendQueue() override;
+};
+
+#endif  // __TRANSPORT_H__
@@ -0,0 +1,216 @@
+// Offline asset packer.
+// Converts the loose files in the assets directory into one bundle the client maps at startup
+// (see AssetBundle.h): images decoded to the sprite atlas's pixel format, sounds converted to
+// PCM in the mixer's output format, and fonts copied as they are. Run it again whenever an
+// asset, or the client's audio rate, changes; the client falls back to the loose files when
+// there is no bundle and converts sounds itself if the rate does not match.
+//
+// Usage: AssetPacker [--assets DIR] [--out assets/assets.bundle] [--rate 48000] [--channels 2]
+
+#include "AssetBundle.h"
+#include "SDL_image.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// An entry and the bytes it will point at
+struct PackedEntry {
+    BundleEntry entry;
+    std::vector<Uint8> data;
+};
+
+static bool packImage(const std::filesystem::path& file, PackedEntry& packed) {
+    SDL_Surface* loaded = IMG_Load(file.string().c_str());
+    if (!loaded) {
+        std::cerr << "Failed to load image " << file << ": " << IMG_GetError() << std::endl;
+        return false;
+    }
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);  // The atlas format
+    SDL_FreeSurface(loaded);
+    if (!converted) {
+        std::cerr << "Failed to convert image " << file << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    packed.entry.type = BUNDLE_IMAGE;
+    packed.entry.width = (Uint32)converted->w;
+    packed.entry.height = (Uint32)converted->h;
+    packed.entry.pitch = (Uint32)converted->w * 4;  // Rows packed tightly
+    packed.entry.pixelFormat = converted->format->format;
+    packed.data.resize((size_t)packed.entry.pitch * converted->h);
+    SDL_LockSurface(converted);
+    for (int y = 0; y < converted->h; y++) {
+        memcpy(&packed.data[(size_t)y * packed.entry.pitch], (Uint8*)converted->pixels + (size_t)y * converted->pitch, packed.entry.pitch);
+    }
+    SDL_UnlockSurface(converted);
+    SDL_FreeSurface(converted);
+    return true;
+}
+
+static bool packSound(const std::filesystem::path& file, const BundleHeader& header, PackedEntry& packed) {
+    SDL_AudioSpec spec;
+    Uint8* buffer = nullptr;
+    Uint32 length = 0;
+    if (!SDL_LoadWAV(file.string().c_str(), &spec, &buffer, &length)) {
+        std::cerr << "Failed to load sound " << file << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq, header.audioFormat, (Uint8)header.audioChannels,
+                          (int)header.audioFrequency) < 0) {
+        std::cerr << "Cannot convert sound " << file << ": " << SDL_GetError() << std::endl;
+        SDL_FreeWAV(buffer);
+        return false;
+    }
+    std::vector<Uint8> pcm((size_t)length * std::max(1, cvt.len_mult));
+    memcpy(pcm.data(), buffer, length);
+    SDL_FreeWAV(buffer);
+    cvt.buf = pcm.data();
+    cvt.len = (int)length;
+    cvt.len_cvt = (int)length;
+    if (cvt.needed && SDL_ConvertAudio(&cvt) < 0) {
+        std::cerr << "Failed to convert sound " << file << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+    pcm.resize((size_t)cvt.len_cvt);
+
+    packed.entry.type = BUNDLE_SOUND;
+    packed.data = std::move(pcm);
+    return true;
+}
+
+static bool packFile(const std::filesystem::path& file, PackedEntry& packed) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        std::cerr << "Failed to read " << file << std::endl;
+        return false;
+    }
+    packed.entry.type = BUNDLE_FONT;
+    packed.data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string assets = "assets";
+    std::string out;
+    BundleHeader header = {};
+    header.magic = BUNDLE_MAGIC;
+    header.version = BUNDLE_VERSION;
+    header.audioFrequency = 48000;  // The client's requested mixer rate
+    header.audioFormat = AUDIO_S16SYS;  // MIX_DEFAULT_FORMAT
+    header.audioChannels = 2;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--assets") == 0 && i + 1 < argc) {
+            assets = argv[++i];
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out = argv[++i];
+        }
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            header.audioFrequency = (Uint32)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--channels") == 0 && i + 1 < argc) {
+            header.audioChannels = (Uint16)atoi(argv[++i]);
+        }
+    }
+    if (out.empty()) {
+        out = (std::filesystem::path(assets) / "assets.bundle").string();
+    }
+
+    if (SDL_Init(0) == -1) {
+        std::cerr << "SDL_Init: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    IMG_Init(IMG_INIT_PNG | IMG_INIT_WEBP);
+
+    // Sorted, so the same assets always give the same bundle
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (const auto& item : std::filesystem::directory_iterator(assets, error)) {
+        if (item.is_regular_file()) {
+            files.push_back(item.path());
+        }
+    }
+    if (error) {
+        std::cerr << "Cannot read " << assets << ": " << error.message() << std::endl;
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<PackedEntry> entries;
+    for (const std::filesystem::path& file : files) {
+        std::string extension = file.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+        // Images are found by sprite name ("bg"), everything else by file name
+        PackedEntry packed = {};
+        std::string name;
+        bool ok;
+        if (extension == ".png" || extension == ".jpg" || extension == ".webp") {
+            name = file.stem().string();
+            ok = packImage(file, packed);
+        }
+        else if (extension == ".wav") {
+            name = file.filename().string();
+            ok = packSound(file, header, packed);
+        }
+        else if (extension == ".otf" || extension == ".ttf") {
+            name = file.filename().string();
+            ok = packFile(file, packed);
+        }
+        else {
+            continue;  // Not an asset (or an older bundle)
+        }
+        if (!ok) {
+            return 1;
+        }
+        if (name.length() >= BUNDLE_NAME_LENGTH) {
+            std::cerr << "Name too long for the bundle: " << name << std::endl;
+            return 1;
+        }
+        strncpy(packed.entry.name, name.c_str(), BUNDLE_NAME_LENGTH - 1);
+        packed.entry.size = packed.data.size();
+        entries.push_back(std::move(packed));
+    }
+
+    // Lay the data out after the index, each entry aligned for direct use
+    header.entryCount = (Uint32)entries.size();
+    Uint64 offset = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+    for (PackedEntry& packed : entries) {
+        offset = (offset + BUNDLE_ALIGNMENT - 1) / BUNDLE_ALIGNMENT * BUNDLE_ALIGNMENT;
+        packed.entry.offset = offset;
+        offset += packed.entry.size;
+    }
+
+    std::ofstream file(out, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Cannot write " << out << std::endl;
+        return 1;
+    }
+    file.write((const char*)&header, sizeof(header));
+    for (const PackedEntry& packed : entries) {
+        file.write((const char*)&packed.entry, sizeof(packed.entry));
+    }
+    static const char padding[BUNDLE_ALIGNMENT] = {};
+    for (const PackedEntry& packed : entries) {
+        Uint64 position = (Uint64)file.tellp();
+        file.write(padding, (std::streamsize)(packed.entry.offset - position));
+        file.write((const char*)packed.data.data(), (std::streamsize)packed.data.size());
+        std::cout << "  " << packed.entry.name << ": " << packed.data.size() << " bytes" << std::endl;
+    }
+    if (!file) {
+        std::cerr << "Failed writing " << out << std::endl;
+        return 1;
+    }
+    std::cout << "Packed " << entries.size() << " assets into " << out << " (" << offset << " bytes, audio "
+              << header.audioFrequency << " Hz, " << header.audioChannels << " channels)" << std::endl;
+
+    IMG_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -13,4 +13,21 @@ public class NetworkMessages {
 
     public static final String BALL_HIT_BAT1 = "BALL_HIT_BAT1";
     public static final String BALL_HIT_BAT2 = "BALL_HIT_BAT2";
+
+    // Handshake: HELLO,<version>,<capabilities>[,<resume token>] from the client,
+    // WELCOME,<version>,<slot>,<tick rate>,<capabilities>,<resume token>,<resumed> back
+    public static final String HELLO = "HELLO";
+    public static final String WELCOME = "WELCOME";
+    public static final int PROTOCOL_VERSION = 1;
+    public static final int TICK_RATE = 60;
+    public static final String HEARTBEAT = "HEARTBEAT";  // Sent by idle clients so the server knows they are alive
+
+    // Capability bits, the same values as the client's Protocol.h
+    public static final int CAP_CIPHER = 1;            // XOR stage on the channel
+    public static final int CAP_BINARY_SNAPSHOTS = 2;  // Snapshots as binary records instead of text
+    public static final int CAP_COMPRESSION = 4;       // Compressed messages
+    public static final int CAP_SHM_TRANSPORT = 8;     // Shared-memory transport on the same machine
+
+    // What this server implements
+    public static final int SERVER_CAPABILITIES = CAP_CIPHER;
 }
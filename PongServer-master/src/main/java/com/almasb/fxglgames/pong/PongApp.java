@@ -37,16 +37,24 @@ import com.almasb.fxgl.input.UserAction;
 import com.almasb.fxgl.net.*;
 import com.almasb.fxgl.physics.CollisionHandler;
 import com.almasb.fxgl.physics.HitBox;
+import com.almasb.fxgl.physics.PhysicsComponent;
 import com.almasb.fxgl.ui.UI;
+import javafx.application.Platform;
 import javafx.scene.input.KeyCode;
 import javafx.scene.paint.Color;
 import javafx.util.Duration;
 
+import java.io.DataInputStream;
+import java.io.DataOutputStream;
+import java.io.EOFException;
 import java.io.InputStream;
-import java.io.InputStreamReader;
 import java.io.OutputStream;
-import java.io.PrintWriter;
+import java.nio.charset.StandardCharsets;
+import java.security.SecureRandom;
+import java.util.ArrayDeque;
+import java.util.ArrayList;
 import java.util.Arrays;
+import java.util.HashMap;
 import java.util.Map;
 import java.util.concurrent.ArrayBlockingQueue;
 import java.util.concurrent.BlockingQueue;
@@ -84,19 +92,55 @@ public class PongApp extends GameApplication implements MessageHandler<String> {
     private Entity player1;
     private Entity player2;
     private Entity ball;
-    int connectionID;
     // private BatComponent player1Bat;
     // private BatComponent player2Bat;
     private PlayerCharacterComponent player1Character;
     private PlayerCharacterComponent player2Character;
 
     private Server<String> server;
-    long last_time = System.nanoTime();
-    private int nextPlayerID = 1;
+    private long serverTick = 0;  // Simulation frames run so far
+    private final Map<Integer, Integer> playerSlots = new HashMap<>();  // connection number -> player slot from the handshake
+
+    // Sessions survive a dropped connection for RESUME_WINDOW_MS: the slot stays reserved and a
+    // HELLO carrying the session's token gets it back. Connections that send nothing at all for
+    // CLIENT_TIMEOUT_MS (clients send HEARTBEAT when idle) are closed so their slot is freed.
+    private static final long RESUME_WINDOW_MS = 30000;
+    private static final long CLIENT_TIMEOUT_MS = 5000;
+    private final SecureRandom random = new SecureRandom();
+    private final Map<Integer, String> sessionTokens = new HashMap<>();  // connection number -> resume token
+    private final Map<String, Integer> tokenSlots = new HashMap<>();     // resume token -> player slot
+    private final Map<Integer, Long> reservedUntil = new HashMap<>();    // player slot -> end of its resume window (ms)
+    private final Map<Integer, Long> lastHeard = new HashMap<>();        // connection number -> time of its last message (ms)
 
     int player1Score;
     int player2Score;
 
+    // Client inputs are applied one per tick, in sequence order, so clients can replay
+    // their unacknowledged inputs on top of each snapshot
+    private static final int MAX_BUFFERED_INPUTS = 4;  // Older inputs are skipped if a client gets this far ahead
+    private static final int BUTTON_UP = 1;
+    private static final int BUTTON_DOWN = 2;
+    private final Map<Integer, ArrayDeque<long[]>> pendingInputs = new HashMap<>(); // player slot -> {seq, buttons, dispatch ns}
+    private final Map<Integer, Integer> lastAppliedInput = new HashMap<>();         // player slot -> last seq applied
+
+    // Input timing reported back to each client: how long its last input waited before the tick
+    // that used it (ms, positive = early) or, if the paddle went without input while a key was
+    // held, how many ms too late it was (negative). The wait is measured from when onReceive ran
+    // on the FX thread, not from when the bytes reached the socket, so time spent queued for the
+    // FX thread is not in it
+    private final Map<Integer, Double> inputMargins = new HashMap<>();
+    private final Map<Integer, Integer> lastAppliedButtons = new HashMap<>();
+    private final Map<Integer, Integer> starvedTicks = new HashMap<>();
+    private double tickMs = 1000.0 / 60;
+
+    // Rollback matches: the clients simulate the game themselves and the server relays their
+    // input frames, deciding when the match starts, the shared input delay and the frame order
+    private final Map<Integer, Integer> rollbackDelays = new HashMap<>();  // player slot -> requested input delay
+    private final Map<Integer, Integer> lastRelayedFrame = new HashMap<>(); // player slot -> last frame relayed
+    private boolean rollbackActive = false;
+    private static final int SYNC_VALUES = 13;  // SYNC,<tick>,<rolling hash>,<11 state fields>
+    private final Map<String, String> syncHashes = new HashMap<>();  // tick -> first player's hash, until the other arrives
+
     @Override
     protected void initInput() {
         // Player 1 Controls
@@ -159,19 +203,17 @@ public class PongApp extends GameApplication implements MessageHandler<String> {
     @Override
     protected void initGame() {
         Writers.INSTANCE.addTCPWriter(String.class, outputStream -> new MessageWriterS(outputStream));
-        Readers.INSTANCE.addTCPReader(String.class, in -> new MessageReaderS(in));
+        Readers.INSTANCE.addTCPReader(String.class, in -> new MessageReaderS(in, key));
 
         server = getNetService().newTCPServer(55555, new ServerConfig<>(String.class));
 
         server.setOnConnected(connection -> {
-            int playerID = nextPlayerID++;  // Assign and increment the player ID
-            //playerIDs.put(connection, playerID);  // Store the player ID in the map for this connection
-
-            // Send the playerID to the client
-            //connection.send("PLAYER_ID," + playerID);
-
             connection.addMessageHandlerFX(this);
         });
+        server.setOnDisconnected(connection -> {
+            // Called on the connection's thread; the session maps belong to the FX thread
+            Platform.runLater(() -> onDisconnected(connection));
+        });
 
         getGameWorld().addEntityFactory(new PongFactory());
         getGameScene().setBackgroundColor(Color.rgb(0, 0, 5));
@@ -240,19 +282,55 @@ public class PongApp extends GameApplication implements MessageHandler<String> {
 
     @Override
     protected void onUpdate(double tpf) {
-        long time = System.nanoTime();
-        long deltaTime =  (int) ((time - last_time) / 1000000);
-        last_time = time;
-        if (deltaTime >= 1) {
-            server.broadcast(xorCypher(String.valueOf(deltaTime), key));
-            if (!server.getConnections().isEmpty()) {
-                var message = "GAME_DATA," + player1.getY() + "," + player2.getY() + "," + ball.getX() + "," + ball.getY() + "," + player1.getX() + "," + player2.getX() + "," + connectionID + "," + player1Score + "," + player2Score;
-                message = xorCypher(message, key);
-                server.broadcast(message);
+        serverTick++;
+        tickMs = tpf * 1000;
+        if (!server.getConnections().isEmpty()) {
+            for (var connection : server.getConnections()) {
+                connection.send(xorCypher(gameDataFor(slotOf(connection)), key));
             }
+            dropSilentConnections();
         }
+
+        applyQueuedInput(1, player1Character);
+        applyQueuedInput(2, player2Character);
     }
 
+    // Apply the next buffered input for a player; with nothing buffered the paddle stops
+    private void applyQueuedInput(int slot, PlayerCharacterComponent character) {
+        var queue = pendingInputs.get(slot);
+        if (queue == null) {
+            return;  // Player is driven by the local keyboard or legacy key events
+        }
+        if (queue.isEmpty()) {
+            if (lastAppliedButtons.getOrDefault(slot, 0) != 0) {
+                starvedTicks.merge(slot, 1, Integer::sum);  // Key held but the next input isn't here yet
+            }
+            character.stop();  // Held keys arrive as one input per tick, so a gap means no input
+            return;
+        }
+
+        while (queue.size() > MAX_BUFFERED_INPUTS) {
+            lastAppliedInput.put(slot, (int) queue.poll()[0]);
+        }
+
+        long[] input = queue.poll();
+        lastAppliedInput.put(slot, (int) input[0]);
+        lastAppliedButtons.put(slot, (int) input[1]);
+
+        int starved = starvedTicks.getOrDefault(slot, 0);
+        starvedTicks.put(slot, 0);
+        inputMargins.put(slot, starved > 0 ? -starved * tickMs : (System.nanoTime() - input[2]) / 1e6);
+
+        boolean up = (input[1] & BUTTON_UP) != 0;
+        boolean down = (input[1] & BUTTON_DOWN) != 0;
+        if (up && !down) {
+            character.moveUp();
+        } else if (down && !up) {
+            character.moveDown();
+        } else {
+            character.stop();
+        }
+    }
 
     private void initScreenBounds() {
         Entity walls = entityBuilder()
@@ -285,89 +363,337 @@ public class PongApp extends GameApplication implements MessageHandler<String> {
 
     @Override
     public void onReceive(Connection<String> connection, String message) {
-        connectionID = connection.getConnectionNum();
+        lastHeard.put(connection.getConnectionNum(), System.currentTimeMillis());
         var tokens = message.split(",");
-        System.out.println("Processing connection number: " + connectionID);
-
-        Arrays.stream(tokens).skip(1).forEach(key -> {
-            if (connectionID == 1) { // CLIENT1's controls
-                if (key.endsWith("_DOWN")) {
-                    if (key.equals("W_DOWN")) {
-                        getInput().mockKeyPress(KeyCode.W); // Maps W to Up1 action for CLIENT1
-                    } else if (key.equals("S_DOWN")) {
-                        getInput().mockKeyPress(KeyCode.S); // Maps S to Down1 action for CLIENT1
-                    }
-                } else if (key.endsWith("_UP")) {
-                    if (key.equals("W_UP")) {
-                        getInput().mockKeyRelease(KeyCode.W);
-                    } else if (key.equals("S_UP")) {
-                        getInput().mockKeyRelease(KeyCode.S);
+        if (tokens[0].equals(HELLO)) {
+            handleHello(connection, tokens);
+            return;
+        }
+        int slot = slotOf(connection);
 
-                    }
+        // CLIENT_DATA,INPUT,<seq>,<buttons>,INPUT,... with legacy key tokens still accepted
+        var relay = new StringBuilder();
+        for (int i = 1; i < tokens.length; i++) {
+            if (tokens[i].equals("INPUT") && i + 2 < tokens.length) {
+                try {
+                    int seq = Integer.parseInt(tokens[i + 1]);
+                    int buttons = Integer.parseInt(tokens[i + 2]);
+                    pendingInputs.computeIfAbsent(slot, id -> new ArrayDeque<>()).add(new long[] { seq, buttons, System.nanoTime() });
+                } catch (NumberFormatException e) {
+                    System.out.println("Bad INPUT from player " + slot + ": " + message);
                 }
-            } else if (connectionID == 2) { // CLIENT2's controls
-                if (key.endsWith("_DOWN")) {
-                    if (key.equals("W_DOWN")) {
-                        getInput().mockKeyPress(KeyCode.I); // Maps W to Up1 action for CLIENT1
-                    } else if (key.equals("S_DOWN")) {
-                        getInput().mockKeyPress(KeyCode.K); // Maps S to Down1 action for CLIENT1
-                    }
-                } else if (key.endsWith("_UP")) {
-                    if (key.equals("W_UP")) {
-                        getInput().mockKeyRelease(KeyCode.I);
-                    } else if (key.equals("S_UP")) {
-                        getInput().mockKeyRelease(KeyCode.K);
-                    }
+                i += 2;
+            } else if (tokens[i].equals("PING") && i + 1 < tokens.length) {
+                // Echo the client's timestamp with ours so it can estimate RTT and clock offset
+                connection.send(xorCypher("PONG," + tokens[i + 1] + "," + serverTimeMs() + "," + serverTick, key));
+                i += 1;
+            } else if (tokens[i].equals("FRAME") && i + 2 < tokens.length) {
+                relayFrame(slot, tokens[i + 1], tokens[i + 2], relay);
+                i += 2;
+            } else if (tokens[i].equals("SYNC") && i + SYNC_VALUES < tokens.length) {
+                var values = Arrays.copyOfRange(tokens, i + 1, i + 1 + SYNC_VALUES);
+                checkSync(slot, values[0], values[1]);
+                sendTo(slot == 1 ? 2 : 1, "PEER_SYNC," + String.join(",", values));
+                i += SYNC_VALUES;
+            } else if (tokens[i].equals(HEARTBEAT)) {
+                // Only keeps the connection alive
+            } else if (tokens[i].equals("ROLLBACK_JOIN") && i + 1 < tokens.length) {
+                joinRollback(slot, tokens[i + 1]);
+                i += 1;
+            } else {
+                applyKey(slot, tokens[i]);
+            }
+        }
+
+        if (relay.length() > 0) {
+            sendTo(slot == 1 ? 2 : 1, "PEER_INPUT" + relay);
+        }
+    }
+
+    // Start a rollback match once both players have asked for one, using the larger input delay
+    private void joinRollback(int slot, String delay) {
+        if (slot != 1 && slot != 2) {
+            return;
+        }
+        try {
+            rollbackDelays.put(slot, Integer.parseInt(delay));
+        } catch (NumberFormatException e) {
+            return;
+        }
+
+        if (rollbackDelays.size() == 2) {
+            int inputDelay = Math.max(rollbackDelays.get(1), rollbackDelays.get(2));
+            lastRelayedFrame.clear();
+            rollbackActive = true;
+            sendTo(1, "ROLLBACK_START,1," + inputDelay);
+            sendTo(2, "ROLLBACK_START,2," + inputDelay);
+            System.out.println("Rollback match started with an input delay of " + inputDelay);
+        }
+    }
+
+    // Compare both players' rolling state hashes for a tick and report any disagreement
+    private void checkSync(int slot, String tick, String hash) {
+        var other = syncHashes.remove(tick);
+        if (other == null) {
+            if (syncHashes.size() > 1000) {
+                syncHashes.clear();  // A player stopped sending; don't grow forever
+            }
+            syncHashes.put(tick, hash);
+        } else if (!other.equals(hash)) {
+            System.out.println("Rollback desync at tick " + tick + " (player " + slot + " hash " + hash + ", other " + other + ")");
+        }
+    }
+
+    // Forward a player's input frame to the other player, in order and without duplicates
+    private void relayFrame(int slot, String tickToken, String buttonsToken, StringBuilder relay) {
+        if (!rollbackActive || (slot != 1 && slot != 2)) {
+            return;
+        }
+        try {
+            int tick = Integer.parseInt(tickToken);
+            int buttons = Integer.parseInt(buttonsToken);
+            if (tick <= lastRelayedFrame.getOrDefault(slot, -1)) {
+                return;
+            }
+            lastRelayedFrame.put(slot, tick);
+            relay.append(",").append(tick).append(",").append(buttons);
+        } catch (NumberFormatException e) {
+            System.out.println("Bad FRAME from player " + slot);
+        }
+    }
+
+    // Each client gets its own player slot and the last of its inputs included in this state;
+    // the ball's velocity (px/s) lets clients predict it between snapshots, and the server tick and
+    // time let them place the snapshot on the server's timeline. The last field is the input
+    // margin, counted from the input's dispatch to onReceive (see inputMargins)
+    private String gameDataFor(int slot) {
+        var ballPhysics = ball.getComponent(PhysicsComponent.class);
+        return "GAME_DATA," + player1.getY() + "," + player2.getY() + "," + ball.getX() + "," + ball.getY() + "," + player1.getX() + "," + player2.getX() + "," + slot + "," + player1Score + "," + player2Score + "," + lastAppliedInput.getOrDefault(slot, 0) + "," + ballPhysics.getVelocityX() + "," + ballPhysics.getVelocityY() + "," + serverTick + "," + serverTimeMs() + "," + inputMargins.getOrDefault(slot, 0.0);
+    }
 
+    // Keep a player's slot for a while so the same session can reconnect, and stop anything
+    // that depended on the player being there
+    private void onDisconnected(Connection<String> connection) {
+        int connNum = connection.getConnectionNum();
+        Integer slot = playerSlots.remove(connNum);
+        lastHeard.remove(connNum);
+        String token = sessionTokens.remove(connNum);
+        if (slot == null || slot == 0) {
+            if (token != null) {
+                tokenSlots.remove(token);
+            }
+            return;
+        }
+
+        reservedUntil.put(slot, System.currentTimeMillis() + RESUME_WINDOW_MS);
+        var queue = pendingInputs.get(slot);
+        if (queue != null) {
+            queue.clear();
+        }
+        if (rollbackActive || rollbackDelays.containsKey(slot)) {
+            // The rollback match cannot continue with one side missing; both clients rejoin
+            rollbackActive = false;
+            rollbackDelays.clear();
+            syncHashes.clear();
+            sendTo(slot == 1 ? 2 : 1, "ROLLBACK_STOP");
+        }
+        System.out.println("Player " + slot + " disconnected; slot held for " + RESUME_WINDOW_MS / 1000 + " s");
+    }
 
+    // Close connections that have gone quiet; their slot is then reserved like any other drop
+    private void dropSilentConnections() {
+        long now = System.currentTimeMillis();
+        for (var connection : new ArrayList<>(server.getConnections())) {
+            Long heard = lastHeard.get(connection.getConnectionNum());
+            if (heard != null && now - heard > CLIENT_TIMEOUT_MS) {
+                System.out.println("Connection " + connection.getConnectionNum() + " timed out");
+                lastHeard.remove(connection.getConnectionNum());
+                connection.terminate();
+            }
+        }
+    }
+
+    // A slot is taken while a connection holds it or its previous owner may still resume it
+    private boolean isSlotTaken(int slot) {
+        if (playerSlots.containsValue(slot)) {
+            return true;
+        }
+        Long until = reservedUntil.get(slot);
+        if (until != null && until > System.currentTimeMillis()) {
+            return true;
+        }
+        reservedUntil.remove(slot);
+        tokenSlots.values().remove(slot);  // The old session can no longer resume
+        return false;
+    }
+
+    private String newSessionToken() {
+        var bytes = new byte[8];
+        random.nextBytes(bytes);
+        var token = new StringBuilder();
+        for (byte b : bytes) {
+            token.append(String.format("%02x", b));
+        }
+        return token.toString();
+    }
+
+    // Player slot of a connection: assigned by the handshake. Clients that never sent HELLO get
+    // their connection number as before, but only while no handshake client holds or may resume
+    // a paddle; otherwise two connections would drive the same one, so they watch as spectators
+    private int slotOf(Connection<String> connection) {
+        Integer slot = playerSlots.get(connection.getConnectionNum());
+        if (slot != null) {
+            return slot;
+        }
+        return isSlotTaken(1) || isSlotTaken(2) ? 0 : connection.getConnectionNum();
+    }
+
+    // HELLO,<protocol version>,<capability bits>[,<resume token>]: assign a player slot and agree on
+    // the options both sides support; answered with
+    // WELCOME,<version>,<slot>,<tick rate>,<chosen capabilities>,<resume token>,<1 if resumed>
+    private void handleHello(Connection<String> connection, String[] tokens) {
+        int version = PROTOCOL_VERSION;
+        int offered = 0;
+        try {
+            version = Math.min(PROTOCOL_VERSION, Integer.parseInt(tokens[1]));
+            offered = Integer.parseInt(tokens[2]);
+        } catch (ArrayIndexOutOfBoundsException | NumberFormatException e) {
+            System.out.println("Malformed HELLO from connection " + connection.getConnectionNum());
+        }
+
+        // A known token gets its slot back; a connection still holding it is the session's
+        // old link that has not timed out yet, so it is closed
+        int slot = 0;  // Spectator unless a paddle is free
+        String token = tokens.length > 3 ? tokens[3] : null;
+        Integer previous = token != null ? tokenSlots.get(token) : null;
+        boolean resumed = previous != null && previous != 0;
+        if (resumed) {
+            slot = previous;
+            reservedUntil.remove(slot);
+            for (var stale : new ArrayList<>(server.getConnections())) {
+                int staleNum = stale.getConnectionNum();
+                if (stale != connection && token.equals(sessionTokens.get(staleNum))) {
+                    playerSlots.remove(staleNum);
+                    sessionTokens.remove(staleNum);
+                    stale.terminate();
                 }
             }
-        });
+        } else {
+            for (int candidate = 1; candidate <= 2 && slot == 0; candidate++) {
+                if (!isSlotTaken(candidate)) {
+                    slot = candidate;
+                }
+            }
+            token = newSessionToken();
+            tokenSlots.put(token, slot);
+            if (slot != 0) {
+                // A new session on this paddle: its acks start over rather than continuing the
+                // previous owner's sequence numbers
+                pendingInputs.remove(slot);
+                lastAppliedInput.remove(slot);
+                lastAppliedButtons.remove(slot);
+                starvedTicks.remove(slot);
+                inputMargins.remove(slot);
+            }
+        }
+        playerSlots.put(connection.getConnectionNum(), slot);
+        sessionTokens.put(connection.getConnectionNum(), token);
+
+        // The TCP reader always decrypts, so the cipher is not optional on this server
+        int chosen = (offered & SERVER_CAPABILITIES) | CAP_CIPHER;
+        connection.send(xorCypher(WELCOME + "," + version + "," + slot + "," + TICK_RATE + "," + chosen + "," + token + "," + (resumed ? 1 : 0), key));
+        System.out.println("Connection " + connection.getConnectionNum() + (resumed ? " resumed" : " joined") + " as player " + slot + " (protocol " + version + ", capabilities " + chosen + ")");
+
+        if (resumed) {
+            // Bring the client straight up to date instead of waiting for the next tick
+            connection.send(xorCypher("SCORES," + geti("player1score") + "," + geti("player2score"), key));
+            connection.send(xorCypher(gameDataFor(slot), key));
+        }
+    }
+
+    // Monotonic server time in milliseconds, as used for clock synchronisation
+    private static double serverTimeMs() {
+        return System.nanoTime() / 1e6;
+    }
+
+    private void sendTo(int slot, String message) {
+        for (var connection : server.getConnections()) {
+            if (slotOf(connection) == slot) {
+                connection.send(xorCypher(message, key));
+            }
+        }
+    }
+
+    // Legacy W_DOWN/W_UP/S_DOWN/S_UP key events, mapped onto the local key bindings
+    private void applyKey(int slot, String key) {
+        if (slot == 1) { // CLIENT1's controls
+            if (key.equals("W_DOWN")) {
+                getInput().mockKeyPress(KeyCode.W); // Maps W to Up1 action for CLIENT1
+            } else if (key.equals("S_DOWN")) {
+                getInput().mockKeyPress(KeyCode.S); // Maps S to Down1 action for CLIENT1
+            } else if (key.equals("W_UP")) {
+                getInput().mockKeyRelease(KeyCode.W);
+            } else if (key.equals("S_UP")) {
+                getInput().mockKeyRelease(KeyCode.S);
+            }
+        } else if (slot == 2) { // CLIENT2's controls
+            if (key.equals("W_DOWN")) {
+                getInput().mockKeyPress(KeyCode.I); // Maps W to Up2 action for CLIENT2
+            } else if (key.equals("S_DOWN")) {
+                getInput().mockKeyPress(KeyCode.K); // Maps S to Down2 action for CLIENT2
+            } else if (key.equals("W_UP")) {
+                getInput().mockKeyRelease(KeyCode.I);
+            } else if (key.equals("S_UP")) {
+                getInput().mockKeyRelease(KeyCode.K);
+            }
+        }
     }
 
 
 
+    // Each message is framed with a 16-bit big-endian length prefix so the client can split the stream
     static class MessageWriterS implements TCPMessageWriter<String> {
 
-        private OutputStream os;
-        private PrintWriter out;
+        private DataOutputStream out;
 
         MessageWriterS(OutputStream os) {
-            this.os = os;
-            out = new PrintWriter(os, true);
+            out = new DataOutputStream(os);
         }
 
         @Override
         public void write(String s) throws Exception {
-            out.print(s.toCharArray());
+            byte[] bytes = s.getBytes(StandardCharsets.ISO_8859_1);
+            out.writeShort(bytes.length);
+            out.write(bytes);
             out.flush();
         }
     }
 
+    // Reads length-prefixed frames and decrypts each one before handing it to onReceive
     static class MessageReaderS implements TCPMessageReader<String> {
 
         private BlockingQueue<String> messages = new ArrayBlockingQueue<>(50);
 
-        private InputStreamReader in;
+        private DataInputStream in;
 
-        MessageReaderS(InputStream is) {
-            in =  new InputStreamReader(is);
+        MessageReaderS(InputStream is, String key) {
+            in = new DataInputStream(is);
 
             var t = new Thread(() -> {
                 try {
 
-                    char[] buf = new char[36];
-
-                    int len;
-
-                    while ((len = in.read(buf)) > 0) {
-                        var message = new String(Arrays.copyOf(buf, len));
+                    while (true) {
+                        int len = in.readUnsignedShort();
+                        byte[] buf = new byte[len];
+                        in.readFully(buf);
 
-                        System.out.println("Recv message: " + message);
+                        var message = xorCypher(new String(buf, StandardCharsets.ISO_8859_1), key);
 
                         messages.put(message);
                     }
 
+                } catch (EOFException e) {
+                    // client disconnected
                 } catch (Exception e) {
                     e.printStackTrace();
                 }